@@ -0,0 +1,171 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_DISCOVERY_SERVICE_H_
+#define MAPVIZ_DISCOVERY_SERVICE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QFutureWatcher>
+
+#include <ros/master.h>
+#include <tf/transform_listener.h>
+
+namespace mapviz
+{
+/**
+ * Polls the ROS master for topics, TF for frames and rosapi for services in
+ * one place, on background threads, and caches the results for the
+ * dialogs, combo boxes and plugins that list them.
+ *
+ * Each list is only polled while at least one client is watching it, and
+ * the changed signals are only emitted when the sorted lists actually
+ * change.  All of the public methods must be called from the GUI thread.
+ */
+class DiscoveryService : public QObject
+{
+  Q_OBJECT
+
+ public:
+  static DiscoveryService& Instance();
+
+  /**
+   * Sets the listener that frames are read from.  Mapviz sets this when it
+   * initializes.
+   */
+  void SetTransformListener(const boost::shared_ptr<tf::TransformListener>& tf);
+
+  /**
+   * Registers interest in the topic or frame list; every call must be
+   * matched by a call to the corresponding Unwatch method.
+   */
+  void WatchTopics();
+  void UnwatchTopics();
+  void WatchFrames();
+  void UnwatchFrames();
+
+  /**
+   * Registers interest in the services of a type, or all services if the
+   * type is empty.  Services are listed through rosapi, which is polled
+   * separately from the master and TF since it can be slow or absent.
+   */
+  void WatchServices(const std::string& datatype);
+  void UnwatchServices(const std::string& datatype);
+
+  /**
+   * The most recently discovered topics, sorted by name.
+   */
+  const std::vector<ros::master::TopicInfo>& Topics() const { return topics_; }
+
+  /**
+   * The most recently discovered frames, sorted by name.
+   */
+  const std::vector<std::string>& Frames() const { return frames_; }
+
+  /**
+   * The most recently discovered services of a type, sorted by name.  The
+   * results are kept after the last watcher goes away, so a dialog that is
+   * opened again starts with the previous list.
+   */
+  std::vector<std::string> Services(const std::string& datatype) const;
+
+ Q_SIGNALS:
+  void TopicsChanged();
+  void FramesChanged();
+  void ServicesChanged(const QString& datatype);
+  void ServiceDiscoveryFailed(const QString& datatype, const QString& error);
+
+ private Q_SLOTS:
+  void Poll();
+  void HandlePollResult();
+  void PollServices();
+  void HandleServicesResult();
+  void HandleServicesTimeout();
+
+ private:
+  struct ServiceQuery
+  {
+    ServiceQuery() : watchers(0) {}
+
+    int watchers;
+    std::vector<std::string> services;
+  };
+
+  struct ServiceResult
+  {
+    std::string datatype;
+    bool success;
+    std::string error;
+    std::vector<std::string> services;
+  };
+
+  struct Snapshot
+  {
+    bool has_topics;
+    bool has_frames;
+    std::vector<ros::master::TopicInfo> topics;
+    std::vector<std::string> frames;
+  };
+
+  explicit DiscoveryService(QObject* parent);
+  ~DiscoveryService();
+
+  static Snapshot Fetch(
+      bool topics,
+      boost::shared_ptr<tf::TransformListener> tf);
+
+  static std::vector<ServiceResult> FetchServices(
+      std::vector<std::string> datatypes);
+
+  boost::shared_ptr<tf::TransformListener> tf_;
+
+  int topic_watchers_;
+  int frame_watchers_;
+
+  std::vector<ros::master::TopicInfo> topics_;
+  std::vector<std::string> frames_;
+
+  QTimer poll_timer_;
+  QFutureWatcher<Snapshot> poll_watcher_;
+
+  std::map<std::string, ServiceQuery> service_queries_;
+  QTimer service_poll_timer_;
+  QTimer service_timeout_timer_;
+  QFutureWatcher<std::vector<ServiceResult> > service_watcher_;
+};
+}  // namespace mapviz
+
+#endif  // MAPVIZ_DISCOVERY_SERVICE_H_
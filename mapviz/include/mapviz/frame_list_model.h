@@ -0,0 +1,74 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_FRAME_LIST_MODEL_H_
+#define MAPVIZ_FRAME_LIST_MODEL_H_
+
+#include <string>
+#include <vector>
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QVariant>
+
+namespace mapviz
+{
+/**
+ * A list model of TF frame names for the frame combo boxes.
+ *
+ * The frames are kept sorted, and SetFrames() only inserts and removes the
+ * rows that changed, so views keep their current item and don't have to
+ * rebuild their contents when the TF tree changes.  Optional header entries
+ * (e.g. "<none>") are listed before the frames and never change.
+ */
+class FrameListModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+ public:
+  explicit FrameListModel(const QStringList& headers = QStringList(), QObject* parent = 0);
+
+  /**
+   * Updates the model to contain exactly the given frames, which must be
+   * sorted and unique.
+   */
+  void SetFrames(const std::vector<std::string>& frames);
+
+  const std::vector<std::string>& Frames() const { return frames_; }
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+
+ private:
+  QStringList headers_;
+  std::vector<std::string> frames_;
+};
+}  // namespace mapviz
+
+#endif  // MAPVIZ_FRAME_LIST_MODEL_H_
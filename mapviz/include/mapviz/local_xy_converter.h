@@ -0,0 +1,129 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_LOCAL_XY_CONVERTER_H_
+#define MAPVIZ_LOCAL_XY_CONVERTER_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <swri_transform_util/local_xy_util.h>
+
+namespace mapviz
+{
+/**
+ * Converts arrays of points between WGS84 and the LocalXY frame.
+ *
+ * The LocalXY projection is linear in latitude and longitude for a given
+ * origin, so its coefficients are captured once from the LocalXY util and
+ * then applied to whole arrays at a time instead of going through the util
+ * (or the transform manager) one point at a time.
+ *
+ * Every origin that has been seen gets an id, starting at 1.  Points that
+ * were converted with an older origin can be reprojected to the current
+ * one in bulk, which lets displays keep their history when the origin
+ * arrives late or changes.
+ *
+ * A single converter is shared by every display using the same LocalXY
+ * util; see Get().  It isn't thread safe and is meant to be used from the
+ * GUI thread.
+ */
+class LocalXyConverter
+{
+ public:
+  static boost::shared_ptr<LocalXyConverter> Get(
+      const swri_transform_util::LocalXyWgs84UtilPtr& util);
+
+  explicit LocalXyConverter(
+      const swri_transform_util::LocalXyWgs84UtilPtr& util);
+
+  /**
+   * Picks up the origin if it was initialized or changed since the last
+   * call and returns the id of the current origin, or 0 if there is none.
+   */
+  int Update();
+
+  int Origin() const { return static_cast<int>(projections_.size()); }
+
+  bool Initialized() const { return !projections_.empty(); }
+
+  std::string Frame() const;
+
+  /**
+   * Converts count points with the current origin.  The output arrays may
+   * alias the input arrays.
+   */
+  void ToLocalXy(
+      size_t count,
+      const double* latitude,
+      const double* longitude,
+      double* x,
+      double* y) const;
+
+  void ToWgs84(
+      size_t count,
+      const double* x,
+      const double* y,
+      double* latitude,
+      double* longitude) const;
+
+  /**
+   * Moves count LocalXY points from an older origin to the current one, in
+   * place.  The change in heading is returned in yaw, if given.  Returns
+   * false if the origin id is unknown.
+   */
+  bool Reproject(
+      int origin,
+      size_t count,
+      double* x,
+      double* y,
+      double* yaw = NULL) const;
+
+ private:
+  // Maps degrees relative to the reference point to LocalXY:
+  //   x = m[0] * dlat + m[1] * dlon
+  //   y = m[2] * dlat + m[3] * dlon
+  struct Projection
+  {
+    double latitude;
+    double longitude;
+    double angle;
+    double m[4];
+    double inverse[4];
+  };
+
+  swri_transform_util::LocalXyWgs84UtilPtr util_;
+  std::vector<Projection> projections_;
+};
+typedef boost::shared_ptr<LocalXyConverter> LocalXyConverterPtr;
+}
+
+#endif  // MAPVIZ_LOCAL_XY_CONVERTER_H_
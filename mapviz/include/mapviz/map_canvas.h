@@ -77,6 +77,12 @@ namespace mapviz
     QPointF MapGlCoordToFixedFrame(const QPointF& point);
     QPointF FixedFrameToMapGlCoord(const QPointF& point);
 
+    /**
+     * The transform from the fixed frame to widget coordinates used by
+     * FixedFrameToMapGlCoord().
+     */
+    const QTransform& ViewTransform() const { return qtransform_; }
+
     double frameRate() const;
 
     float ViewScale() const { return view_scale_; }
@@ -31,6 +31,7 @@
 #define MAPVIZ_MAPVIZ_H_
 
 // C++ standard libraries
+#include <deque>
 #include <string>
 #include <vector>
 #include <map>
@@ -51,6 +52,9 @@
 #include <QWidget>
 #include <QStringList>
 #include <QMainWindow>
+#include <QMutex>
+#include <QFuture>
+#include <QFile>
 
 // ROS libraries
 #include <ros/ros.h>
@@ -65,7 +69,10 @@
 
 #include <swri_transform_util/transform_manager.h>
 #include <mapviz/AddMapvizDisplay.h>
+#include <mapviz/ConfigureMapvizDisplays.h>
+#include <mapviz/MapvizDisplay.h>
 #include <mapviz/mapviz_plugin.h>
+#include <mapviz/frame_list_model.h>
 #include <mapviz/map_canvas.h>
 #include <mapviz/video_writer.h>
 
@@ -120,6 +127,8 @@ namespace mapviz
     void Recenter();
     void HandleProfileTimer();
     void ClearHistory();
+    void LoadPendingDisplays();
+    void FinishStartupTimeline();
 
   Q_SIGNALS:
     /**
@@ -136,11 +145,12 @@ namespace mapviz
 
     QMenu* image_transport_menu_;
 
-    QTimer frame_timer_;
     QTimer spin_timer_;
     QTimer save_timer_;
     QTimer record_timer_;
     QTimer profile_timer_;
+    QTimer load_timer_;
+    QTimer startup_timer_;
 
     QLabel* xy_pos_label_;
     QLabel* lat_lon_pos_label_;
@@ -165,14 +175,35 @@ namespace mapviz
 
     std::string save_location_;
 
+    // The last config written by AutoSave, so unchanged configs are not
+    // rewritten, and the write that may still be in progress.
+    std::string autosave_path_;
+    std::string autosave_snapshot_;
+    QFuture<bool> autosave_future_;
+
+    // Where the startup timeline is reported once the startup is finished.
+    bool print_startup_timeline_;
+    std::string startup_trace_;
+
+    // Last known display data, saved at shutdown and restored as the
+    // displays of a config are created.  The file is memory mapped while
+    // the displays are being loaded.
+    bool snapshot_enabled_;
+    std::string snapshot_path_;
+    boost::shared_ptr<QFile> snapshot_file_;
+    std::map<std::pair<std::string, std::string>, std::pair<const uchar*, size_t> > snapshot_entries_;
+
     std::string capture_directory_;
     QThread video_thread_;
     VideoWriter* vid_writer_;
 
     bool updating_frames_;
+    FrameListModel* fixed_frames_;
+    FrameListModel* target_frames_;
 
     ros::NodeHandle* node_;
     ros::ServiceServer add_display_srv_;
+    ros::ServiceServer configure_displays_srv_;
     boost::shared_ptr<tf::TransformListener> tf_;
     swri_transform_util::TransformManagerPtr tf_manager_;
 
@@ -180,22 +211,63 @@ namespace mapviz
     MapCanvas* canvas_;
     std::map<QListWidgetItem*, MapvizPluginPtr> plugins_;
 
+    // Displays from a config file that have not been created yet.  They are
+    // brought online one per event loop iteration while their plugin
+    // libraries are loaded in the background.
+    struct PendingDisplay
+    {
+      std::string name;
+      std::string type;
+      bool visible;
+      bool collapsed;
+      YAML::Node config;
+      std::string config_path;
+    };
+    std::deque<PendingDisplay> pending_displays_;
+    std::vector<std::string> failed_plugins_;
+
+    // Guards loader_, which is not thread safe
+    QMutex loader_mutex_;
+    QFuture<void> library_future_;
+
     Stopwatch meas_spin_;
 
     void Open(const std::string& filename);
     void Save(const std::string& filename);
+    std::string SerializeConfig(const std::string& config_path);
+    static bool WriteConfig(const std::string& filename, const std::string& contents);
 
     MapvizPluginPtr CreateNewDisplay(
         const std::string& name,
         const std::string& type,
         bool visible,
         bool collapsed,
-        int draw_order = 0);
+        int draw_order = 0,
+        bool reorder = true);
 
     bool AddDisplay(
       AddMapvizDisplay::Request& req,
       AddMapvizDisplay::Response& resp);
 
+    bool ConfigureDisplays(
+      ConfigureMapvizDisplays::Request& req,
+      ConfigureMapvizDisplays::Response& resp);
+
+    bool ApplyDisplays(
+      const std::vector<MapvizDisplay>& displays,
+      std::string& message);
+
+    void PreloadLibraries(const std::vector<std::string>& types);
+    void LoadDisplay(const PendingDisplay& display);
+    void FinishLoading();
+    void ReportFailedPlugins();
+
+    void ScheduleStartupReport();
+
+    void MapSnapshot();
+    void ReleaseSnapshot();
+    void SaveSnapshot();
+
     void ClearDisplays();
     void AdjustWindowSize();
 
@@ -31,23 +31,33 @@
 #define MAPVIZ_MAPVIZ_PLUGIN_H_
 
 // C++ standard libraries
+#include <exception>
+#include <map>
 #include <string>
+#include <vector>
 
+#include <boost/function.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 
 // QT libraries
 #include <QWidget>
 #include <QGLWidget>
+#include <QImage>
 #include <QObject>
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
 
 // ROS libraries
 #include <ros/ros.h>
+#include <ros/serialization.h>
 #include <tf/transform_datatypes.h>
 #include <swri_transform_util/transform.h>
 #include <swri_transform_util/transform_manager.h>
 #include <swri_yaml_util/yaml_util.h>
 
+#include <mapviz/startup_timeline.h>
 #include <mapviz/widgets.h>
 
 #include "stopwatch.h"
@@ -114,6 +124,13 @@ namespace mapviz
     {
       if (visible_ && initialized_)
       {
+        bool first_draw = !first_draw_recorded_;
+        ros::WallTime first_draw_start;
+        if (first_draw)
+        {
+          first_draw_start = ros::WallTime::now();
+        }
+
         meas_transform_.start();
         Transform();
         meas_transform_.stop();
@@ -121,6 +138,11 @@ namespace mapviz
         meas_draw_.start();
         Draw(x, y, scale);
         meas_draw_.stop();
+
+        if (first_draw)
+        {
+          RecordFirstDraw(first_draw_start);
+        }
       }
     }
     
@@ -138,6 +160,45 @@ namespace mapviz
       }
     }
 
+    /**
+     * Draws the plugin's screen-space overlay, if it has one.  The overlay
+     * is kept in a pixmap that is only repainted after UpdateHud() is called
+     * or its size changes; otherwise the cached pixmap (which the GL paint
+     * engine keeps as a texture) is drawn as is.
+     */
+    void CompositeHud(QPainter* painter, bool antialiasing)
+    {
+      if (!visible_ || !initialized_ || !SupportsHud())
+      {
+        return;
+      }
+
+      QRect rect = HudRect();
+      if (rect.isEmpty())
+      {
+        return;
+      }
+
+      if (hud_painted_revision_ != hud_revision_ || hud_pixmap_.size() != rect.size())
+      {
+        meas_paint_.start();
+        QImage image(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter image_painter(&image);
+        image_painter.setRenderHints(QPainter::Antialiasing |
+                                     QPainter::TextAntialiasing |
+                                     QPainter::SmoothPixmapTransform,
+                                     antialiasing);
+        PaintHud(&image_painter, rect.size());
+        image_painter.end();
+        hud_pixmap_ = QPixmap::fromImage(image);
+        hud_painted_revision_ = hud_revision_;
+        meas_paint_.stop();
+      }
+
+      painter->drawPixmap(rect.topLeft(), hud_pixmap_);
+    }
+
     void SetTargetFrame(std::string frame_id)
     {
       if (frame_id != target_frame_)
@@ -159,6 +220,7 @@ namespace mapviz
       if (visible_ != visible)
       {
         visible_ = visible;
+        UpdateLazySubscriptions();
         Q_EMIT VisibleChanged(visible_);
       }
     }
@@ -204,6 +266,19 @@ namespace mapviz
 
     virtual QWidget* GetConfigWidget(QWidget* parent) { return NULL; }
 
+    /**
+     * Override this to save the display's last received data into buffer so
+     * that it can be shown immediately on the next start, before live data
+     * arrives.  Returns false if there is nothing to save.
+     */
+    virtual bool SaveSnapshot(std::vector<uint8_t>& buffer) const { return false; }
+
+    /**
+     * Restores data written by SaveSnapshot(); this is called after
+     * LoadConfig().  The data is only valid for the duration of the call.
+     */
+    virtual void LoadSnapshot(const uint8_t* data, size_t size) {}
+
     virtual void PrintError(const std::string& message) = 0;
     virtual void PrintInfo(const std::string& message) = 0;
     virtual void PrintWarning(const std::string& message) = 0;
@@ -234,6 +309,41 @@ namespace mapviz
       return false;
     }
 
+    /**
+     * Override this to return "true" if the plugin draws a screen-space
+     * overlay (text, gauges, images) through HudRect() and PaintHud().
+     * Overlays are composited in a single pass after all of the plugins
+     * have drawn, so they don't need Paint() or their own GL state.
+     */
+    virtual bool SupportsHud()
+    {
+      return false;
+    }
+
+    /**
+     * Where the overlay goes on the canvas, in pixels.  An empty rect hides
+     * it.  Moving the rect doesn't repaint the overlay.
+     */
+    virtual QRect HudRect()
+    {
+      return QRect();
+    }
+
+    /**
+     * Paints the overlay into a transparent image of the given size; (0, 0)
+     * is the top left corner of HudRect().
+     */
+    virtual void PaintHud(QPainter* painter, const QSize& size) {}
+
+    /**
+     * Marks the overlay as changed so that it is repainted the next time the
+     * canvas is drawn.
+     */
+    void UpdateHud()
+    {
+      hud_revision_++;
+    }
+
   Q_SIGNALS:
     void DrawOrderChanged(int draw_order);
     void SizeChanged();
@@ -263,6 +373,70 @@ namespace mapviz
 
     virtual bool Initialize(QGLWidget* canvas) = 0;
 
+    /**
+     * Helpers for plugins that snapshot the last ROS message they received.
+     */
+    template <class M>
+    static void SerializeSnapshot(const M& msg, std::vector<uint8_t>& buffer)
+    {
+      buffer.resize(ros::serialization::serializationLength(msg));
+      if (!buffer.empty())
+      {
+        ros::serialization::OStream stream(&buffer[0], buffer.size());
+        ros::serialization::serialize(stream, msg);
+      }
+    }
+
+    template <class M>
+    static bool DeserializeSnapshot(const uint8_t* data, size_t size, M& msg)
+    {
+      try
+      {
+        ros::serialization::IStream stream(const_cast<uint8_t*>(data), size);
+        ros::serialization::deserialize(stream, msg);
+      }
+      catch (const ros::serialization::StreamOverrunException& e)
+      {
+        ROS_WARN("Discarding invalid snapshot: %s", e.what());
+        return false;
+      }
+      catch (const std::exception& e)
+      {
+        // A corrupt array length is passed to resize() before the stream is
+        // checked, which throws std::bad_alloc or std::length_error.
+        ROS_WARN("Discarding invalid snapshot: %s", e.what());
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * Manages a subscription that is only active while the display is
+     * visible.  The subscriber is shut down when the display is hidden, so a
+     * hidden display costs no bandwidth or deserialization, and subscribe is
+     * called to recreate it when the display is shown again.  Latched topics
+     * deliver their last message again on resubscription.
+     *
+     * Calling this again for the same subscriber replaces its subscription.
+     */
+    void SubscribeLazily(
+        ros::Subscriber& subscriber,
+        const boost::function<ros::Subscriber()>& subscribe)
+    {
+      lazy_subscriptions_[&subscriber] = subscribe;
+      subscriber.shutdown();
+      if (visible_)
+      {
+        subscriber = subscribe();
+      }
+    }
+
+    void UnsubscribeLazily(ros::Subscriber& subscriber)
+    {
+      lazy_subscriptions_.erase(&subscriber);
+      subscriber.shutdown();
+    }
+
     MapvizPlugin() :
       initialized_(false),
       visible_(true),
@@ -271,7 +445,11 @@ namespace mapviz
       tf_(),
       target_frame_(""),
       source_frame_(""),
-      draw_order_(0) {}
+      draw_order_(0),
+      created_(ros::WallTime::now()),
+      first_draw_recorded_(false),
+      hud_revision_(1),
+      hud_painted_revision_(0) {}
 
    private:
     // Collect basic profiling info to know how much time each plugin
@@ -279,6 +457,41 @@ namespace mapviz
     Stopwatch meas_transform_;
     Stopwatch meas_paint_;
     Stopwatch meas_draw_;
+
+    std::map<ros::Subscriber*, boost::function<ros::Subscriber()> > lazy_subscriptions_;
+
+    // Plugins are drawn once they are initialized, which they do when their
+    // first message arrives, so the first draw also marks (to within a
+    // frame) when the display's data became available.
+    ros::WallTime created_;
+    bool first_draw_recorded_;
+
+    uint64_t hud_revision_;
+    uint64_t hud_painted_revision_;
+    QPixmap hud_pixmap_;
+
+    void RecordFirstDraw(const ros::WallTime& start)
+    {
+      first_draw_recorded_ = true;
+      StartupTimeline& timeline = StartupTimeline::Instance();
+      timeline.Record("Waiting for data", name_, created_, start);
+      timeline.Record("First draw", name_, start, ros::WallTime::now());
+    }
+
+    void UpdateLazySubscriptions()
+    {
+      for (auto& subscription: lazy_subscriptions_)
+      {
+        if (visible_)
+        {
+          *subscription.first = subscription.second();
+        }
+        else
+        {
+          subscription.first->shutdown();
+        }
+      }
+    }
   };
   typedef boost::shared_ptr<MapvizPlugin> MapvizPluginPtr;
 
@@ -83,6 +83,7 @@ class SelectFrameDialog : public QDialog
    */
   SelectFrameDialog(boost::shared_ptr<tf::TransformListener> tf_listener,
                     QWidget *parent=0);
+  ~SelectFrameDialog();
   
   /**
    * Choose whether the user can select one (allow=false) or multiple
@@ -104,9 +105,6 @@ class SelectFrameDialog : public QDialog
   std::vector<std::string> selectedFrames() const;
 
  private:
-  void timerEvent(QTimerEvent *);
-  void closeEvent(QCloseEvent *);
-
   std::vector<std::string> filterFrames(
     const std::vector<std::string> &) const;
 
@@ -118,7 +116,6 @@ class SelectFrameDialog : public QDialog
   boost::shared_ptr<tf::TransformListener> tf_;
   std::vector<std::string> known_frames_;
   std::vector<std::string> displayed_frames_;
-  int fetch_frames_timer_id_;
 
   QPushButton *ok_button_;
   QPushButton *cancel_button_;
@@ -32,15 +32,10 @@
 #define MAPVIZ_SELECT_SERVICE_DIALOG_H
 
 #include <set>
+#include <string>
 #include <vector>
 
-#include <boost/shared_ptr.hpp>
-
 #include <QDialog>
-#include <QMetaType>
-#include <QThread>
-
-#include <ros/ros.h>
 
 QT_BEGIN_NAMESPACE
 class QLineEdit;
@@ -48,38 +43,8 @@ class QListWidget;
 class QPushButton;
 QT_END_NAMESPACE
 
-// This is ugly, but necessary in order to be able to send a std::vector<std::string>
-// via a queued signal/slot connection.
-typedef std::vector<std::string> ServiceStringVector;
-Q_DECLARE_METATYPE(ServiceStringVector);
-
 namespace mapviz
 {
-  /**
-   * Enumerating services requires making a remote service call; doing this in the GUI thread
-   * could cause Mapviz to block and become unresponsive, so it is offloaded to another thread.
-   */
-  class ServiceUpdaterThread : public QThread
-  {
-    Q_OBJECT
-  public:
-    ServiceUpdaterThread(ros::NodeHandle& nh, const std::string& allowed_datatype, QObject* parent) :
-      QThread(parent),
-      nh_(nh),
-      allowed_datatype_(allowed_datatype)
-    {
-    }
-    void run();
-
-  Q_SIGNALS:
-    void servicesFetched(ServiceStringVector services);
-    void fetchingFailed(const QString error_msg);
-
-  private:
-    ros::NodeHandle& nh_;
-    const std::string& allowed_datatype_;
-  };
-
   /**
    * Provides a dialog that the user can use to either list all known ROS services
    * or all ROS services that handle a particular type.
@@ -100,8 +65,9 @@ namespace mapviz
     static std::string selectService(const std::string& datatype, QWidget* parent=0);
 
     /**
-     * Constructs a new SelectServiceDialog and automatically starts a timer that
-     * will refresh the list of services every 5 seconds.
+     * Constructs a new SelectServiceDialog.  It starts with the services
+     * already known to the DiscoveryService, which keeps refreshing them in
+     * the background while the dialog is open.
      * @param[in] datatype The type of service to search for; if empty, it will show
      *                     the user a list of all services.
      * @param[in] parent The dialog's parent widget.
@@ -125,44 +91,35 @@ namespace mapviz
     std::string selectedService() const;
 
   private Q_SLOTS:
-    /**
-     * If no worker thread is currently active, this will start a worker thread
-     * that will fetch all of the services matching the known data type.
-     */
-    void fetchServices();
     /**
      * Updates the list of services displayed to the user based on the list
      * of known services and the current filter value.
      */
     void updateDisplayedServices();
     /**
-     * Sets our list of known services.
+     * Updates our list of known services if the services of our data type
+     * changed.
      */
-    void updateKnownServices(ServiceStringVector services);
+    void updateKnownServices(const QString& datatype);
     /**
-     * Displays a message box indicating that there was an error and stops our
-     * update timer.
+     * Displays a message box indicating that there was an error; this is
+     * only done once per dialog.
      */
-    void displayUpdateError(const QString);
+    void displayUpdateError(const QString& datatype, const QString& error_msg);
 
   private:
     std::vector<std::string> filterServices();
-    void timerEvent(QTimerEvent *);
-    void closeEvent(QCloseEvent *);
-
-    ros::NodeHandle nh_;
 
     std::string allowed_datatype_;
     std::vector<std::string> displayed_services_;
     std::vector<std::string> known_services_;
 
-    int fetch_services_timer_id_;
+    bool error_shown_;
 
     QPushButton *cancel_button_;
     QListWidget *list_widget_;
     QLineEdit *name_filter_;
     QPushButton *ok_button_;
-    boost::shared_ptr<ServiceUpdaterThread> worker_thread_;
   };
 }
 
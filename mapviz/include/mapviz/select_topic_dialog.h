@@ -131,6 +131,7 @@ class SelectTopicDialog : public QDialog
    * Constructor for the SelectTopicDialog.
    */
   SelectTopicDialog(QWidget *parent=0);
+  ~SelectTopicDialog();
   
   /**
    * Choose whether the user can select one (allow=false) or multiple
@@ -159,9 +160,6 @@ class SelectTopicDialog : public QDialog
   std::vector<ros::master::TopicInfo> selectedTopics() const;
 
  private:
-  void timerEvent(QTimerEvent *);
-  void closeEvent(QCloseEvent *);
-
   std::vector<ros::master::TopicInfo> filterTopics(
     const std::vector<ros::master::TopicInfo> &) const;
 
@@ -173,7 +171,6 @@ class SelectTopicDialog : public QDialog
   std::set<std::string> allowed_datatypes_;
   std::vector<ros::master::TopicInfo> known_topics_;
   std::vector<ros::master::TopicInfo> displayed_topics_;
-  int fetch_topics_timer_id_;
 
   QPushButton *ok_button_;
   QPushButton *cancel_button_;
@@ -0,0 +1,123 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_STARTUP_TIMELINE_H_
+#define MAPVIZ_STARTUP_TIMELINE_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <ros/time.h>
+
+namespace mapviz
+{
+/**
+ * Collects how long each phase of startup takes, both for mapviz itself
+ * (ROS init, GL init, the plugin scan) and for each display (library load,
+ * construction, LoadConfig, waiting for the first message and the first
+ * draw).
+ *
+ * Intervals can be recorded from any thread until Finish() is called; after
+ * that, further intervals are ignored so that displays added later don't
+ * show up in the timeline.  The report is printed to the ROS console and
+ * the trace is written in the Chrome trace event format, which can be
+ * viewed with chrome://tracing or Perfetto.
+ */
+class StartupTimeline
+{
+ public:
+  static StartupTimeline& Instance();
+
+  /**
+   * Records an interval.  The display is empty for phases of mapviz itself;
+   * for library loads it is the plugin type.
+   */
+  void Record(
+      const std::string& phase,
+      const std::string& display,
+      const ros::WallTime& start,
+      const ros::WallTime& end);
+
+  /**
+   * Stops recording.  Returns false if this was already called.
+   */
+  bool Finish();
+
+  bool Finished() const;
+
+  void PrintReport() const;
+
+  bool WriteTrace(const std::string& filename) const;
+
+ private:
+  struct Interval
+  {
+    std::string phase;
+    std::string display;
+    ros::WallTime start;
+    ros::WallTime end;
+    bool main_thread;
+  };
+
+  StartupTimeline();
+
+  mutable boost::mutex mutex_;
+  bool finished_;
+  std::vector<Interval> intervals_;
+};
+
+/**
+ * Records the interval between its construction and destruction.
+ */
+class ScopedStartupPhase
+{
+ public:
+  ScopedStartupPhase(const std::string& phase, const std::string& display = std::string())
+    :
+    phase_(phase),
+    display_(display),
+    start_(ros::WallTime::now())
+  {
+  }
+
+  ~ScopedStartupPhase()
+  {
+    StartupTimeline::Instance().Record(phase_, display_, start_, ros::WallTime::now());
+  }
+
+ private:
+  std::string phase_;
+  std::string display_;
+  ros::WallTime start_;
+};
+}  // namespace mapviz
+
+#endif  // MAPVIZ_STARTUP_TIMELINE_H_
@@ -0,0 +1,379 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz/discovery_service.h>
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <rosapi/Services.h>
+#include <rosapi/ServicesForType.h>
+
+namespace mapviz
+{
+// rosapi is polled less often than the master since listing services
+// makes it contact every node that provides one.
+static const int SERVICE_POLL_MS = 5000;
+
+// How long a service poll may take before watchers are told that rosapi
+// isn't responding.  The poll itself can't be cancelled; its results are
+// still used if it eventually finishes.
+static const int SERVICE_TIMEOUT_MS = 3000;
+
+static bool topicSort(const ros::master::TopicInfo &info1,
+                      const ros::master::TopicInfo &info2)
+{
+  return info1.name < info2.name;
+}
+
+static bool topicsEqual(const std::vector<ros::master::TopicInfo>& topics1,
+                        const std::vector<ros::master::TopicInfo>& topics2)
+{
+  if (topics1.size() != topics2.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < topics1.size(); i++)
+  {
+    if (topics1[i].name != topics2[i].name ||
+        topics1[i].datatype != topics2[i].datatype)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+DiscoveryService& DiscoveryService::Instance()
+{
+  // Owned by the application so that it is destroyed before Qt shuts down.
+  static DiscoveryService* instance =
+      new DiscoveryService(QCoreApplication::instance());
+  return *instance;
+}
+
+DiscoveryService::DiscoveryService(QObject* parent) :
+  QObject(parent),
+  topic_watchers_(0),
+  frame_watchers_(0)
+{
+  connect(&poll_timer_, SIGNAL(timeout()), this, SLOT(Poll()));
+  connect(&poll_watcher_, SIGNAL(finished()), this, SLOT(HandlePollResult()));
+
+  connect(&service_poll_timer_, SIGNAL(timeout()), this, SLOT(PollServices()));
+  connect(&service_watcher_, SIGNAL(finished()), this, SLOT(HandleServicesResult()));
+  service_timeout_timer_.setSingleShot(true);
+  connect(&service_timeout_timer_, SIGNAL(timeout()), this, SLOT(HandleServicesTimeout()));
+}
+
+DiscoveryService::~DiscoveryService()
+{
+  poll_timer_.stop();
+  poll_watcher_.waitForFinished();
+  service_poll_timer_.stop();
+  service_watcher_.waitForFinished();
+}
+
+void DiscoveryService::SetTransformListener(
+    const boost::shared_ptr<tf::TransformListener>& tf)
+{
+  tf_ = tf;
+  if (frame_watchers_ > 0)
+  {
+    Poll();
+  }
+}
+
+void DiscoveryService::WatchTopics()
+{
+  topic_watchers_++;
+  if (topic_watchers_ == 1)
+  {
+    Poll();
+  }
+}
+
+void DiscoveryService::UnwatchTopics()
+{
+  topic_watchers_ = std::max(0, topic_watchers_ - 1);
+}
+
+void DiscoveryService::WatchFrames()
+{
+  frame_watchers_++;
+  if (frame_watchers_ == 1)
+  {
+    Poll();
+  }
+}
+
+void DiscoveryService::UnwatchFrames()
+{
+  frame_watchers_ = std::max(0, frame_watchers_ - 1);
+}
+
+void DiscoveryService::Poll()
+{
+  if (topic_watchers_ == 0 && frame_watchers_ == 0)
+  {
+    poll_timer_.stop();
+    return;
+  }
+
+  if (!poll_timer_.isActive())
+  {
+    poll_timer_.start(1000);
+  }
+
+  if (poll_watcher_.isRunning())
+  {
+    // A slow master shouldn't queue up requests.
+    return;
+  }
+
+  boost::shared_ptr<tf::TransformListener> tf;
+  if (frame_watchers_ > 0)
+  {
+    tf = tf_;
+  }
+
+  poll_watcher_.setFuture(
+      QtConcurrent::run(&DiscoveryService::Fetch, topic_watchers_ > 0, tf));
+}
+
+DiscoveryService::Snapshot DiscoveryService::Fetch(
+    bool topics,
+    boost::shared_ptr<tf::TransformListener> tf)
+{
+  Snapshot snapshot;
+
+  snapshot.has_topics = topics && ros::master::getTopics(snapshot.topics);
+  if (snapshot.has_topics)
+  {
+    std::sort(snapshot.topics.begin(), snapshot.topics.end(), topicSort);
+  }
+
+  snapshot.has_frames = static_cast<bool>(tf);
+  if (snapshot.has_frames)
+  {
+    tf->getFrameStrings(snapshot.frames);
+    std::sort(snapshot.frames.begin(), snapshot.frames.end());
+  }
+
+  return snapshot;
+}
+
+void DiscoveryService::HandlePollResult()
+{
+  const Snapshot& snapshot = poll_watcher_.result();
+
+  if (snapshot.has_topics && !topicsEqual(snapshot.topics, topics_))
+  {
+    topics_ = snapshot.topics;
+    Q_EMIT TopicsChanged();
+  }
+
+  if (snapshot.has_frames && snapshot.frames != frames_)
+  {
+    frames_ = snapshot.frames;
+    Q_EMIT FramesChanged();
+  }
+}
+
+void DiscoveryService::WatchServices(const std::string& datatype)
+{
+  ServiceQuery& query = service_queries_[datatype];
+  query.watchers++;
+  if (query.watchers == 1)
+  {
+    PollServices();
+  }
+}
+
+void DiscoveryService::UnwatchServices(const std::string& datatype)
+{
+  std::map<std::string, ServiceQuery>::iterator query = service_queries_.find(datatype);
+  if (query != service_queries_.end())
+  {
+    query->second.watchers = std::max(0, query->second.watchers - 1);
+  }
+}
+
+std::vector<std::string> DiscoveryService::Services(const std::string& datatype) const
+{
+  std::map<std::string, ServiceQuery>::const_iterator query = service_queries_.find(datatype);
+  if (query == service_queries_.end())
+  {
+    return std::vector<std::string>();
+  }
+  return query->second.services;
+}
+
+void DiscoveryService::PollServices()
+{
+  std::vector<std::string> datatypes;
+  for (const auto& query: service_queries_)
+  {
+    if (query.second.watchers > 0)
+    {
+      datatypes.push_back(query.first);
+    }
+  }
+
+  if (datatypes.empty())
+  {
+    service_poll_timer_.stop();
+    return;
+  }
+
+  if (!service_poll_timer_.isActive())
+  {
+    service_poll_timer_.start(SERVICE_POLL_MS);
+  }
+
+  if (service_watcher_.isRunning())
+  {
+    return;
+  }
+
+  service_timeout_timer_.start(SERVICE_TIMEOUT_MS);
+  service_watcher_.setFuture(
+      QtConcurrent::run(&DiscoveryService::FetchServices, datatypes));
+}
+
+std::vector<DiscoveryService::ServiceResult> DiscoveryService::FetchServices(
+    std::vector<std::string> datatypes)
+{
+  ros::NodeHandle nh;
+  std::vector<ServiceResult> results(datatypes.size());
+  for (size_t i = 0; i < datatypes.size(); i++)
+  {
+    ServiceResult& result = results[i];
+    result.datatype = datatypes[i];
+    result.success = false;
+
+    ros::ServiceClient client;
+    if (result.datatype.empty())
+    {
+      client = nh.serviceClient<rosapi::Services>("/rosapi/services");
+    }
+    else
+    {
+      client = nh.serviceClient<rosapi::ServicesForType>("/rosapi/services_for_type");
+    }
+
+    if (!client.waitForExistence(ros::Duration(1)))
+    {
+      // Check to see whether the rosapi services are actually running.
+      result.error = "Unable to list ROS services.  Is rosapi_node running?";
+      continue;
+    }
+
+    if (result.datatype.empty())
+    {
+      rosapi::Services srv;
+
+      ROS_DEBUG("Listing all services.");
+      if (client.call(srv))
+      {
+        result.services = srv.response.services;
+        result.success = true;
+      }
+      else
+      {
+        result.error = "Unable to list ROS services.";
+      }
+    }
+    else
+    {
+      rosapi::ServicesForType srv;
+      srv.request.type = result.datatype;
+
+      ROS_DEBUG("Listing services for type %s", srv.request.type.c_str());
+      if (client.call(srv))
+      {
+        result.services = srv.response.services;
+        result.success = true;
+      }
+      else
+      {
+        // If there are any dead or unreachable nodes that provide services, even if
+        // they're not of the service type we're looking for, the services_for_type
+        // service will have an error and not return anything.  Super annoying.
+        result.error = "Unable to list ROS services.  You may have "
+                       "dead nodes; try running \"rosnode cleanup\".";
+      }
+    }
+
+    std::sort(result.services.begin(), result.services.end());
+  }
+
+  return results;
+}
+
+void DiscoveryService::HandleServicesResult()
+{
+  service_timeout_timer_.stop();
+
+  const std::vector<ServiceResult>& results = service_watcher_.result();
+  for (const auto& result: results)
+  {
+    QString datatype = QString::fromStdString(result.datatype);
+    if (!result.success)
+    {
+      Q_EMIT ServiceDiscoveryFailed(datatype, QString::fromStdString(result.error));
+      continue;
+    }
+
+    ServiceQuery& query = service_queries_[result.datatype];
+    if (result.services != query.services)
+    {
+      query.services = result.services;
+      Q_EMIT ServicesChanged(datatype);
+    }
+  }
+}
+
+void DiscoveryService::HandleServicesTimeout()
+{
+  for (const auto& query: service_queries_)
+  {
+    if (query.second.watchers > 0)
+    {
+      Q_EMIT ServiceDiscoveryFailed(
+          QString::fromStdString(query.first),
+          tr("Unable to list ROS services.  rosapi_node is not responding."));
+    }
+  }
+}
+}  // namespace mapviz
@@ -0,0 +1,116 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz/frame_list_model.h>
+
+namespace mapviz
+{
+FrameListModel::FrameListModel(const QStringList& headers, QObject* parent) :
+  QAbstractListModel(parent),
+  headers_(headers)
+{
+}
+
+void FrameListModel::SetFrames(const std::vector<std::string>& frames)
+{
+  const int offset = headers_.size();
+
+  // Walk both sorted lists and apply each run of removed or added frames
+  // as a single row change.
+  size_t i = 0;
+  size_t j = 0;
+  while (i < frames_.size() || j < frames.size())
+  {
+    if (j == frames.size() || (i < frames_.size() && frames_[i] < frames[j]))
+    {
+      size_t end = i + 1;
+      while (end < frames_.size() && (j == frames.size() || frames_[end] < frames[j]))
+      {
+        end++;
+      }
+
+      beginRemoveRows(QModelIndex(), offset + i, offset + end - 1);
+      frames_.erase(frames_.begin() + i, frames_.begin() + end);
+      endRemoveRows();
+    }
+    else if (i == frames_.size() || frames[j] < frames_[i])
+    {
+      size_t end = j + 1;
+      while (end < frames.size() && (i == frames_.size() || frames[end] < frames_[i]))
+      {
+        end++;
+      }
+
+      beginInsertRows(QModelIndex(), offset + i, offset + i + (end - j) - 1);
+      frames_.insert(frames_.begin() + i, frames.begin() + j, frames.begin() + end);
+      endInsertRows();
+
+      i += end - j;
+      j = end;
+    }
+    else
+    {
+      i++;
+      j++;
+    }
+  }
+}
+
+int FrameListModel::rowCount(const QModelIndex& parent) const
+{
+  if (parent.isValid())
+  {
+    return 0;
+  }
+
+  return headers_.size() + static_cast<int>(frames_.size());
+}
+
+QVariant FrameListModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+  {
+    return QVariant();
+  }
+
+  int row = index.row();
+  if (row < headers_.size())
+  {
+    return headers_[row];
+  }
+
+  row -= headers_.size();
+  if (row < 0 || static_cast<size_t>(row) >= frames_.size())
+  {
+    return QVariant();
+  }
+
+  return QString::fromStdString(frames_[row]);
+}
+}  // namespace mapviz
@@ -0,0 +1,201 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz/local_xy_converter.h>
+
+#include <cmath>
+#include <map>
+
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace mapviz
+{
+LocalXyConverterPtr LocalXyConverter::Get(
+    const swri_transform_util::LocalXyWgs84UtilPtr& util)
+{
+  static std::map<swri_transform_util::LocalXyWgs84Util*,
+                  boost::weak_ptr<LocalXyConverter> > converters;
+
+  LocalXyConverterPtr converter = converters[util.get()].lock();
+  if (!converter)
+  {
+    converter = boost::make_shared<LocalXyConverter>(util);
+    converters[util.get()] = converter;
+  }
+
+  return converter;
+}
+
+LocalXyConverter::LocalXyConverter(
+    const swri_transform_util::LocalXyWgs84UtilPtr& util) :
+  util_(util)
+{
+}
+
+int LocalXyConverter::Update()
+{
+  if (!util_ || !util_->Initialized())
+  {
+    return Origin();
+  }
+
+  double latitude = util_->ReferenceLatitude();
+  double longitude = util_->ReferenceLongitude();
+  double angle = util_->ReferenceAngle();
+  if (!projections_.empty() &&
+      projections_.back().latitude == latitude &&
+      projections_.back().longitude == longitude &&
+      projections_.back().angle == angle)
+  {
+    return Origin();
+  }
+
+  Projection projection;
+  projection.latitude = latitude;
+  projection.longitude = longitude;
+  projection.angle = angle;
+
+  // Sample the projection one degree away from the origin in each
+  // direction, stepping towards the equator and the prime meridian so the
+  // samples stay in range.
+  double dlat = latitude > 0.0 ? -1.0 : 1.0;
+  double dlon = longitude > 0.0 ? -1.0 : 1.0;
+  double x0, y0, x1, y1, x2, y2;
+  util_->ToLocalXy(latitude, longitude, x0, y0);
+  util_->ToLocalXy(latitude + dlat, longitude, x1, y1);
+  util_->ToLocalXy(latitude, longitude + dlon, x2, y2);
+  projection.m[0] = (x1 - x0) / dlat;
+  projection.m[1] = (x2 - x0) / dlon;
+  projection.m[2] = (y1 - y0) / dlat;
+  projection.m[3] = (y2 - y0) / dlon;
+
+  double det = projection.m[0] * projection.m[3] -
+               projection.m[1] * projection.m[2];
+  projection.inverse[0] = projection.m[3] / det;
+  projection.inverse[1] = -projection.m[1] / det;
+  projection.inverse[2] = -projection.m[2] / det;
+  projection.inverse[3] = projection.m[0] / det;
+
+  projections_.push_back(projection);
+
+  return Origin();
+}
+
+std::string LocalXyConverter::Frame() const
+{
+  return util_ ? util_->Frame() : std::string();
+}
+
+void LocalXyConverter::ToLocalXy(
+    size_t count,
+    const double* latitude,
+    const double* longitude,
+    double* x,
+    double* y) const
+{
+  if (projections_.empty())
+  {
+    return;
+  }
+
+  const Projection& p = projections_.back();
+  for (size_t i = 0; i < count; i++)
+  {
+    double dlat = latitude[i] - p.latitude;
+    double dlon = longitude[i] - p.longitude;
+    x[i] = p.m[0] * dlat + p.m[1] * dlon;
+    y[i] = p.m[2] * dlat + p.m[3] * dlon;
+  }
+}
+
+void LocalXyConverter::ToWgs84(
+    size_t count,
+    const double* x,
+    const double* y,
+    double* latitude,
+    double* longitude) const
+{
+  if (projections_.empty())
+  {
+    return;
+  }
+
+  const Projection& p = projections_.back();
+  for (size_t i = 0; i < count; i++)
+  {
+    double px = x[i];
+    double py = y[i];
+    latitude[i] = p.latitude + p.inverse[0] * px + p.inverse[1] * py;
+    longitude[i] = p.longitude + p.inverse[2] * px + p.inverse[3] * py;
+  }
+}
+
+bool LocalXyConverter::Reproject(
+    int origin,
+    size_t count,
+    double* x,
+    double* y,
+    double* yaw) const
+{
+  if (origin < 1 || origin > Origin())
+  {
+    return false;
+  }
+
+  const Projection& from = projections_[origin - 1];
+  const Projection& to = projections_.back();
+
+  // Old LocalXY -> WGS84 -> new LocalXY collapses into a single affine map.
+  double a[4];
+  a[0] = to.m[0] * from.inverse[0] + to.m[1] * from.inverse[2];
+  a[1] = to.m[0] * from.inverse[1] + to.m[1] * from.inverse[3];
+  a[2] = to.m[2] * from.inverse[0] + to.m[3] * from.inverse[2];
+  a[3] = to.m[2] * from.inverse[1] + to.m[3] * from.inverse[3];
+  double dlat = from.latitude - to.latitude;
+  double dlon = from.longitude - to.longitude;
+  double tx = to.m[0] * dlat + to.m[1] * dlon;
+  double ty = to.m[2] * dlat + to.m[3] * dlon;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    double px = x[i];
+    double py = y[i];
+    x[i] = a[0] * px + a[1] * py + tx;
+    y[i] = a[2] * px + a[3] * py + ty;
+  }
+
+  if (yaw)
+  {
+    *yaw = std::atan2(a[2], a[0]);
+  }
+
+  return true;
+}
+}
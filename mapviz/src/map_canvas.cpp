@@ -33,6 +33,7 @@
 #include <GL/glu.h>
 
 #include <mapviz/map_canvas.h>
+#include <mapviz/startup_timeline.h>
 
 // C++ standard libraries
 #include <cmath>
@@ -132,6 +133,8 @@ void MapCanvas::InitializePixelBuffers()
 
 void MapCanvas::initializeGL()
 {
+  ScopedStartupPhase phase("GL init");
+
   GLenum err = glewInit();
   if (GLEW_OK != err)
   {
@@ -280,6 +283,15 @@ void MapCanvas::paintEvent(QPaintEvent* event)
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
   p.endNativePainting();
+
+  // Screen-space overlays go on top of everything else, all in one pass.
+  p.save();
+  p.resetTransform();
+  for (it = plugins_.begin(); it != plugins_.end(); ++it)
+  {
+    (*it)->CompositeHud(&p, enable_antialiasing_);
+  }
+  p.restore();
 }
 
 void MapCanvas::pushGlMatrices()
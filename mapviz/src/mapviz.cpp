@@ -32,6 +32,7 @@
 // C++ standard libraries
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include <fstream>
 #include <sstream>
@@ -68,12 +69,16 @@
 #include <QFileInfo>
 #include <QListWidgetItem>
 #include <QMutexLocker>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <swri_math_util/constants.h>
 #include <swri_transform_util/frames.h>
 #include <swri_yaml_util/yaml_util.h>
 
 #include <mapviz/config_item.h>
+#include <mapviz/discovery_service.h>
+#include <mapviz/startup_timeline.h>
 #include <QtGui/QtGui>
 
 #include <image_transport/image_transport.h>
@@ -84,6 +89,27 @@ const QString Mapviz::ROS_WORKSPACE_VAR = "ROS_WORKSPACE";
 const QString Mapviz::MAPVIZ_CONFIG_FILE = "/.mapviz_config";
 const std::string Mapviz::IMAGE_TRANSPORT_PARAM = "image_transport";
 
+// Interval to wait before checking again whether the background thread has
+// loaded the library for the next pending display.
+static const int LIBRARY_POLL_MS = 5;
+
+// Time to wait after the last display of the initial config is created
+// before reporting the startup timeline, so that displays have a chance to
+// receive their first message and draw.
+static const int STARTUP_REPORT_DELAY_MS = 10000;
+
+static std::string ResolvePluginType(const std::string& type)
+{
+  if (type == "mapviz_plugins/mutlires_image")
+  {
+    // The "multires_image" plugin was originally accidentally named "mutlires_image".
+    // Loading a mapviz config file that still has the old name would normally cause it
+    // to crash, so this will check for and correct it.
+    return "mapviz_plugins/multires_image";
+  }
+  return type;
+}
+
 Mapviz::Mapviz(bool is_standalone, int argc, char** argv, QWidget *parent, Qt::WindowFlags flags) :
     QMainWindow(parent, flags),
     xy_pos_label_(new QLabel("fixed: 0.0,0.0")),
@@ -99,6 +125,10 @@ Mapviz::Mapviz(bool is_standalone, int argc, char** argv, QWidget *parent, Qt::W
     capture_directory_("~"),
     vid_writer_(NULL),
     updating_frames_(false),
+    print_startup_timeline_(false),
+    snapshot_enabled_(false),
+    fixed_frames_(NULL),
+    target_frames_(NULL),
     node_(NULL),
     canvas_(NULL)
 {
@@ -167,7 +197,16 @@ Mapviz::Mapviz(bool is_standalone, int argc, char** argv, QWidget *parent, Qt::W
   ui_.actionForce_480p->setActionGroup(group);
   ui_.actionResizable->setActionGroup(group);
 
-  ui_.targetframe->addItem("<none>");
+  fixed_frames_ = new FrameListModel(QStringList(), this);
+  ui_.fixedframe->setModel(fixed_frames_);
+  target_frames_ = new FrameListModel(QStringList("<none>"), this);
+  ui_.targetframe->setModel(target_frames_);
+
+  // The frame models can't insert rows.  A typed frame is applied through
+  // editTextChanged() and added to the model by UpdateFrames() instead, so
+  // frames that TF hasn't published yet can still be entered.
+  ui_.fixedframe->setInsertPolicy(QComboBox::NoInsert);
+  ui_.targetframe->setInsertPolicy(QComboBox::NoInsert);
 
   canvas_ = new MapCanvas(this);
   setCentralWidget(canvas_);
@@ -201,10 +240,17 @@ Mapviz::Mapviz(bool is_standalone, int argc, char** argv, QWidget *parent, Qt::W
 
   ui_.bg_color->setColor(background_);
   canvas_->SetBackground(background_);
+
+  load_timer_.setSingleShot(true);
+  connect(&load_timer_, SIGNAL(timeout()), this, SLOT(LoadPendingDisplays()));
+
+  startup_timer_.setSingleShot(true);
+  connect(&startup_timer_, SIGNAL(timeout()), this, SLOT(FinishStartupTimeline()));
 }
 
 Mapviz::~Mapviz()
 {
+  library_future_.waitForFinished();
   video_thread_.quit();
   video_thread_.wait();
   delete node_;
@@ -217,7 +263,23 @@ void Mapviz::showEvent(QShowEvent* event)
 
 void Mapviz::closeEvent(QCloseEvent* event)
 {
+  // AutoSave() skips the write while an earlier one is still running, so
+  // that one has to finish first for the latest changes to be saved.
+  autosave_future_.waitForFinished();
   AutoSave();
+  autosave_future_.waitForFinished();
+
+  if (snapshot_enabled_ && pending_displays_.empty())
+  {
+    SaveSnapshot();
+  }
+  ReleaseSnapshot();
+
+  startup_timer_.stop();
+  FinishStartupTimeline();
+
+  load_timer_.stop();
+  pending_displays_.clear();
 
   for (auto& display: plugins_)
   {
@@ -237,7 +299,10 @@ void Mapviz::Initialize()
       // If this Mapviz is running as a standalone application, it needs to init
       // ROS and start spinning.  If it's running as an rqt plugin, rqt will
       // take care of that.
-      ros::init(argc_, argv_, "mapviz", ros::init_options::AnonymousName);
+      {
+        ScopedStartupPhase phase("ROS init");
+        ros::init(argc_, argv_, "mapviz", ros::init_options::AnonymousName);
+      }
 
       spin_timer_.start(30);
       connect(&spin_timer_, SIGNAL(timeout()), this, SLOT(SpinOnce()));
@@ -264,10 +329,13 @@ void Mapviz::Initialize()
     tf_manager_ = boost::make_shared<swri_transform_util::TransformManager>();
     tf_manager_->Initialize(tf_);
 
-    loader_ = new pluginlib::ClassLoader<MapvizPlugin>(
-        "mapviz", "mapviz::MapvizPlugin");
-
-    std::vector<std::string> plugins = loader_->getDeclaredClasses();
+    std::vector<std::string> plugins;
+    {
+      ScopedStartupPhase phase("Plugin scan");
+      loader_ = new pluginlib::ClassLoader<MapvizPlugin>(
+          "mapviz", "mapviz::MapvizPlugin");
+      plugins = loader_->getDeclaredClasses();
+    }
     for (unsigned int i = 0; i < plugins.size(); i++)
     {
       ROS_INFO("Found mapviz plugin: %s", plugins[i].c_str());
@@ -280,6 +348,8 @@ void Mapviz::Initialize()
     ros::NodeHandle priv("~");
 
     add_display_srv_ = node_->advertiseService("add_mapviz_display", &Mapviz::AddDisplay, this);
+    configure_displays_srv_ = node_->advertiseService(
+        "configure_mapviz_displays", &Mapviz::ConfigureDisplays, this);
 
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     QString default_path = QDir::homePath();
@@ -308,11 +378,26 @@ void Mapviz::Initialize()
     bool auto_save;
     priv.param("auto_save_backup", auto_save, true);
 
+    priv.param("print_startup_timeline", print_startup_timeline_, false);
+    priv.param("startup_trace", startup_trace_, std::string());
+
+    priv.param("startup_snapshot", snapshot_enabled_, false);
+    priv.param("snapshot_file", snapshot_path_,
+               (QDir::homePath() + "/.mapviz_snapshot").toStdString());
+
     Open(config);
+    if (pending_displays_.empty())
+    {
+      ScheduleStartupReport();
+    }
 
+    // TF is polled for frames by the shared discovery service, which only
+    // notifies us when the frame list changes.
+    DiscoveryService& discovery = DiscoveryService::Instance();
+    discovery.SetTransformListener(tf_);
+    connect(&discovery, SIGNAL(FramesChanged()), this, SLOT(UpdateFrames()));
+    discovery.WatchFrames();
     UpdateFrames();
-    frame_timer_.start(1000);
-    connect(&frame_timer_, SIGNAL(timeout()), this, SLOT(UpdateFrames()));
 
     if (auto_save)
     {
@@ -350,69 +435,48 @@ void Mapviz::SpinOnce()
   }
 }
 
-void Mapviz::UpdateFrames()
+// Returns the sorted frames with the given frame added, so that a selected
+// frame stays in its combo box even when TF doesn't currently know it.
+static std::vector<std::string> WithFrame(
+    const std::vector<std::string>& frames,
+    const std::string& frame)
 {
-  std::vector<std::string> frames;
-  tf_->getFrameStrings(frames);
-  std::sort(frames.begin(), frames.end());
-
-  if (ui_.fixedframe->count() >= 0 &&
-      static_cast<size_t>(ui_.fixedframe->count()) == frames.size())
+  std::vector<std::string> result = frames;
+  if (!frame.empty())
   {
-    bool changed = false;
-    for (size_t i = 0; i < frames.size(); i++)
+    std::vector<std::string>::iterator it =
+        std::lower_bound(result.begin(), result.end(), frame);
+    if (it == result.end() || *it != frame)
     {
-      if (frames[i] != ui_.fixedframe->itemText(i).toStdString())
-      {
-        changed = true;
-      }
+      result.insert(it, frame);
     }
-
-    if (!changed)
-      return;
   }
+  return result;
+}
 
-  updating_frames_ = true;
+void Mapviz::UpdateFrames()
+{
+  const std::vector<std::string>& frames = DiscoveryService::Instance().Frames();
 
   std::string current_fixed = ui_.fixedframe->currentText().toStdString();
-
-  ui_.fixedframe->clear();
-  for (size_t i = 0; i < frames.size(); i++)
-  {
-    ui_.fixedframe->addItem(frames[i].c_str());
-  }
-
-  if (current_fixed != "")
-  {
-    int index = ui_.fixedframe->findText(current_fixed.c_str());
-    if (index < 0)
-    {
-      ui_.fixedframe->addItem(current_fixed.c_str());
-    }
-
-    index = ui_.fixedframe->findText(current_fixed.c_str());
-    ui_.fixedframe->setCurrentIndex(index);
-  }
-
   std::string current_target = ui_.targetframe->currentText().toStdString();
 
-  ui_.targetframe->clear();
-  ui_.targetframe->addItem("<none>");
-  for (size_t i = 0; i < frames.size(); i++)
+  // The models only insert and remove the rows that changed, so the combo
+  // boxes keep their current items.  If the current item of an empty combo
+  // box changes as rows are added, its edit text is put back.
+  updating_frames_ = true;
+
+  fixed_frames_->SetFrames(WithFrame(frames, current_fixed));
+  if (!current_fixed.empty() && ui_.fixedframe->currentText().toStdString() != current_fixed)
   {
-    ui_.targetframe->addItem(frames[i].c_str());
+    ui_.fixedframe->setEditText(current_fixed.c_str());
   }
 
-  if (current_target != "")
+  std::string target = current_target == "<none>" ? std::string() : current_target;
+  target_frames_->SetFrames(WithFrame(frames, target));
+  if (!current_target.empty() && ui_.targetframe->currentText().toStdString() != current_target)
   {
-    int index = ui_.targetframe->findText(current_target.c_str());
-    if (index < 0)
-    {
-      ui_.targetframe->addItem(current_target.c_str());
-    }
-
-    index = ui_.targetframe->findText(current_target.c_str());
-    ui_.targetframe->setCurrentIndex(index);
+    ui_.targetframe->setEditText(current_target.c_str());
   }
 
   updating_frames_ = false;
@@ -548,8 +612,6 @@ void Mapviz::Open(const std::string& filename)
     return;
   }
 
-  std::vector<std::string> failed_plugins;
-
   try
   {
     boost::filesystem::path filepath(filename);
@@ -704,67 +766,376 @@ void Mapviz::Open(const std::string& filename)
       const YAML::Node& displays = doc["displays"];
       for (uint32_t i = 0; i < displays.size(); i++)
       {
-        std::string type, name;
-        displays[i]["type"] >> type;
-        displays[i]["name"] >> name;
+        PendingDisplay display;
+        displays[i]["type"] >> display.type;
+        displays[i]["name"] >> display.name;
 
-        const YAML::Node& config = displays[i]["config"];
+        display.config = displays[i]["config"];
+        display.config_path = config_path;
 
-        bool visible = false;
-        config["visible"] >> visible;
+        display.visible = false;
+        display.config["visible"] >> display.visible;
 
-        bool collapsed = false;
-        config["collapsed"] >> collapsed;
+        display.collapsed = false;
+        display.config["collapsed"] >> display.collapsed;
 
-        try
-        {
-          MapvizPluginPtr plugin =
-              CreateNewDisplay(name, type, visible, collapsed);
-          plugin->LoadConfig(config, config_path);
-          plugin->DrawIcon();
-        }
-        catch (const pluginlib::LibraryLoadException& e)
-        {
-          failed_plugins.push_back(type);
-          ROS_ERROR("%s", e.what());
-        }
+        pending_displays_.push_back(display);
       }
     }
   }
   catch (const YAML::ParserException& e)
   {
     ROS_ERROR("%s", e.what());
+    pending_displays_.clear();
     return;
   }
   catch (const YAML::Exception& e)
   {
     ROS_ERROR("%s", e.what());
+    pending_displays_.clear();
+    return;
+  }
+
+  if (pending_displays_.empty())
+  {
     return;
   }
 
-  if (!failed_plugins.empty())
+  // Creating every display up front can take seconds for a large config, so
+  // the plugin libraries are loaded on a worker thread while the displays
+  // are created one at a time from the event loop.  The canvas keeps
+  // drawing in the meantime.
+  std::vector<std::string> types;
+  for (const auto& display: pending_displays_)
+  {
+    std::string type = ResolvePluginType(display.type);
+    if (std::find(types.begin(), types.end(), type) == types.end())
+    {
+      types.push_back(type);
+    }
+  }
+
+  if (snapshot_enabled_)
+  {
+    MapSnapshot();
+  }
+
+  library_future_.waitForFinished();
+  library_future_ = QtConcurrent::run(this, &Mapviz::PreloadLibraries, types);
+  load_timer_.start(0);
+}
+
+void Mapviz::PreloadLibraries(const std::vector<std::string>& types)
+{
+  for (const auto& type: types)
+  {
+    QMutexLocker locker(&loader_mutex_);
+    try
+    {
+      if (loader_->isClassAvailable(type) && !loader_->isClassLoaded(type))
+      {
+        ScopedStartupPhase phase("Library load", type);
+        loader_->loadLibraryForClass(type);
+      }
+    }
+    catch (const pluginlib::PluginlibException& e)
+    {
+      // The failure is reported when the display is created.
+      ROS_DEBUG("%s", e.what());
+    }
+  }
+}
+
+void Mapviz::LoadPendingDisplays()
+{
+  if (pending_displays_.empty())
+  {
+    return;
+  }
+
+  if (!library_future_.isFinished())
+  {
+    // Don't block the GUI thread while the worker is still loading the
+    // library for the next display.
+    bool loaded = false;
+    if (loader_mutex_.tryLock())
+    {
+      loaded = loader_->isClassLoaded(ResolvePluginType(pending_displays_.front().type));
+      loader_mutex_.unlock();
+    }
+
+    if (!loaded)
+    {
+      load_timer_.start(LIBRARY_POLL_MS);
+      return;
+    }
+  }
+
+  PendingDisplay display = pending_displays_.front();
+  pending_displays_.pop_front();
+  LoadDisplay(display);
+
+  if (pending_displays_.empty())
+  {
+    ReleaseSnapshot();
+    ReportFailedPlugins();
+    ScheduleStartupReport();
+  }
+  else
+  {
+    load_timer_.start(0);
+  }
+}
+
+void Mapviz::LoadDisplay(const PendingDisplay& display)
+{
+  try
+  {
+    MapvizPluginPtr plugin =
+        CreateNewDisplay(display.name, display.type, display.visible, display.collapsed);
+    {
+      ScopedStartupPhase phase("LoadConfig", display.name);
+      plugin->LoadConfig(display.config, display.config_path);
+    }
+    plugin->DrawIcon();
+
+    // Show the last known data until live data arrives
+    std::map<std::pair<std::string, std::string>, std::pair<const uchar*, size_t> >::const_iterator
+        snapshot = snapshot_entries_.find(std::make_pair(display.name, plugin->Type()));
+    if (snapshot != snapshot_entries_.end())
+    {
+      plugin->LoadSnapshot(snapshot->second.first, snapshot->second.second);
+    }
+  }
+  catch (const pluginlib::PluginlibException& e)
+  {
+    failed_plugins_.push_back(display.type);
+    ROS_ERROR("%s", e.what());
+  }
+  catch (const YAML::Exception& e)
+  {
+    ROS_ERROR("%s", e.what());
+  }
+}
+
+void Mapviz::FinishLoading()
+{
+  if (pending_displays_.empty())
+  {
+    return;
+  }
+
+  load_timer_.stop();
+  library_future_.waitForFinished();
+
+  while (!pending_displays_.empty())
+  {
+    PendingDisplay display = pending_displays_.front();
+    pending_displays_.pop_front();
+    LoadDisplay(display);
+  }
+
+  ReleaseSnapshot();
+  ReportFailedPlugins();
+  ScheduleStartupReport();
+}
+
+void Mapviz::ScheduleStartupReport()
+{
+  if (!StartupTimeline::Instance().Finished())
+  {
+    startup_timer_.start(STARTUP_REPORT_DELAY_MS);
+  }
+}
+
+void Mapviz::FinishStartupTimeline()
+{
+  StartupTimeline& timeline = StartupTimeline::Instance();
+  if (!timeline.Finish())
+  {
+    return;
+  }
+
+  if (print_startup_timeline_)
+  {
+    timeline.PrintReport();
+  }
+
+  if (!startup_trace_.empty())
+  {
+    timeline.WriteTrace(startup_trace_);
+  }
+}
+
+void Mapviz::ReportFailedPlugins()
+{
+  if (!failed_plugins_.empty())
   {
     std::stringstream message;
     message << "The following plugin(s) failed to load:" << std::endl;
-    std::string failures = boost::algorithm::join(failed_plugins, "\n");
+    std::string failures = boost::algorithm::join(failed_plugins_, "\n");
     message << failures << std::endl << std::endl << "Check the ROS log for more details.";
+    failed_plugins_.clear();
 
     QMessageBox::warning(this, "Failed to load plugins", QString::fromStdString(message.str()));
   }
 }
 
-void Mapviz::Save(const std::string& filename)
+// The snapshot file starts with SNAPSHOT_MAGIC and an entry count, followed
+// by each entry's display name, type and data, each prefixed by its length.
+static const char SNAPSHOT_MAGIC[8] = {'M', 'V', 'Z', 'S', 'N', 'A', 'P', '1'};
+
+template <class T>
+static bool ReadSnapshotValue(const uchar*& pos, const uchar* end, T& value)
 {
-  std::ofstream fout(filename.c_str());
-  if (fout.fail())
+  if (static_cast<size_t>(end - pos) < sizeof(T))
   {
-    ROS_ERROR("Failed to open file: %s", filename.c_str());
+    return false;
+  }
+  memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+static bool ReadSnapshotString(const uchar*& pos, const uchar* end, std::string& value)
+{
+  uint32_t size = 0;
+  if (!ReadSnapshotValue(pos, end, size) || static_cast<size_t>(end - pos) < size)
+  {
+    return false;
+  }
+  value.assign(reinterpret_cast<const char*>(pos), size);
+  pos += size;
+  return true;
+}
+
+static void WriteSnapshotString(QSaveFile& file, const std::string& value)
+{
+  uint32_t size = value.size();
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(value.data(), size);
+}
+
+void Mapviz::MapSnapshot()
+{
+  ReleaseSnapshot();
+
+  boost::shared_ptr<QFile> file = boost::make_shared<QFile>(QString::fromStdString(snapshot_path_));
+  if (!file->exists())
+  {
+    return;
+  }
+
+  if (!file->open(QIODevice::ReadOnly))
+  {
+    ROS_WARN("Failed to open snapshot: %s", snapshot_path_.c_str());
+    return;
+  }
+
+  // The data is mapped rather than read so that only the pages of the
+  // displays being restored are actually loaded.
+  qint64 file_size = file->size();
+  const uchar* pos = file->map(0, file_size);
+  if (pos == NULL)
+  {
+    ROS_WARN("Failed to map snapshot: %s", snapshot_path_.c_str());
+    return;
+  }
+  const uchar* end = pos + file_size;
+
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  uint32_t count = 0;
+  if (!ReadSnapshotValue(pos, end, magic) ||
+      memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+      !ReadSnapshotValue(pos, end, count))
+  {
+    ROS_WARN("Ignoring invalid snapshot: %s", snapshot_path_.c_str());
     return;
   }
 
+  for (uint32_t i = 0; i < count; i++)
+  {
+    std::string name;
+    std::string type;
+    uint64_t size = 0;
+    if (!ReadSnapshotString(pos, end, name) ||
+        !ReadSnapshotString(pos, end, type) ||
+        !ReadSnapshotValue(pos, end, size) ||
+        static_cast<uint64_t>(end - pos) < size)
+    {
+      ROS_WARN("Snapshot is truncated: %s", snapshot_path_.c_str());
+      break;
+    }
+
+    snapshot_entries_[std::make_pair(name, type)] = std::make_pair(pos, static_cast<size_t>(size));
+    pos += size;
+  }
+
+  snapshot_file_ = file;
+}
+
+void Mapviz::ReleaseSnapshot()
+{
+  snapshot_entries_.clear();
+  snapshot_file_.reset();
+}
+
+void Mapviz::SaveSnapshot()
+{
+  std::vector<std::pair<MapvizPluginPtr, std::vector<uint8_t> > > entries;
+  for (auto& display: plugins_)
+  {
+    std::vector<uint8_t> buffer;
+    if (display.second && display.second->SaveSnapshot(buffer))
+    {
+      entries.push_back(std::make_pair(display.second, std::vector<uint8_t>()));
+      entries.back().second.swap(buffer);
+    }
+  }
+
+  // QSaveFile writes to a temporary file that replaces the old snapshot
+  // when it is committed, so the mapped data stays valid in the meantime.
+  QSaveFile file(QString::fromStdString(snapshot_path_));
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    ROS_ERROR("Failed to open snapshot: %s", snapshot_path_.c_str());
+    return;
+  }
+
+  uint32_t count = entries.size();
+  file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const auto& entry: entries)
+  {
+    WriteSnapshotString(file, entry.first->Name());
+    WriteSnapshotString(file, entry.first->Type());
+    uint64_t size = entry.second.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    if (size > 0)
+    {
+      file.write(reinterpret_cast<const char*>(&entry.second[0]), size);
+    }
+  }
+
+  if (!file.commit())
+  {
+    ROS_ERROR("Failed to write snapshot: %s", snapshot_path_.c_str());
+  }
+}
+
+void Mapviz::Save(const std::string& filename)
+{
+  // Displays that are still being brought online must be written out too
+  FinishLoading();
+
   boost::filesystem::path filepath(filename);
   std::string config_path = filepath.parent_path().string();
 
+  WriteConfig(filename, SerializeConfig(config_path));
+}
+
+std::string Mapviz::SerializeConfig(const std::string& config_path)
+{
   YAML::Emitter out;
 
   out << YAML::BeginMap;
@@ -825,42 +1196,108 @@ void Mapviz::Save(const std::string& filename)
 
   out << YAML::EndMap;
 
-  fout << out.c_str();
+  return out.c_str();
+}
+
+bool Mapviz::WriteConfig(const std::string& filename, const std::string& contents)
+{
+  // Write to a temporary file and rename it over the old config so that a
+  // crash mid-write never leaves a truncated config behind.
+  std::string tmp_filename = filename + ".tmp";
+  std::ofstream fout(tmp_filename.c_str());
+  if (fout.fail())
+  {
+    ROS_ERROR("Failed to open file: %s", tmp_filename.c_str());
+    return false;
+  }
+
+  fout << contents;
   fout.close();
+  if (fout.fail())
+  {
+    ROS_ERROR("Failed to write file: %s", tmp_filename.c_str());
+    return false;
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_filename, filename, ec);
+  if (ec)
+  {
+    ROS_ERROR("Failed to rename %s to %s: %s",
+              tmp_filename.c_str(), filename.c_str(), ec.message().c_str());
+    return false;
+  }
+
+  return true;
 }
 
 void Mapviz::AutoSave()
 {
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  QString default_path = QDir::homePath();
+  if (!pending_displays_.empty())
+  {
+    // Don't replace the backup with a partially loaded config
+    return;
+  }
 
-  if (env.contains(ROS_WORKSPACE_VAR))
+  if (!autosave_future_.isFinished())
   {
-    // Try to save our config in the ROS_WORKSPACE directory, but if we can't write
-    // to that -- probably because it is read-only -- try to use the home directory
-    // instead.
-    QString ws_path = env.value(ROS_WORKSPACE_VAR, default_path);
-    QString ws_file = ws_path + MAPVIZ_CONFIG_FILE;
-    QFileInfo file_info(ws_file);
-    QFileInfo dir_info(ws_path);
-    if ((!file_info.exists() && dir_info.isWritable()) ||
-        file_info.isWritable())
-    {
-      // Note that FileInfo::isWritable will return false if a file does not exist, so
-      // we need to check both if the target file is writable and if the target dir is
-      // writable if the file doesn't exist.
-      default_path = ws_path;
-    }
-    else
+    // The previous write is still in progress; try again on the next tick.
+    return;
+  }
+
+  if (autosave_future_.resultCount() > 0 && !autosave_future_.result())
+  {
+    // Retry a failed write even if nothing has changed since.
+    autosave_snapshot_.clear();
+  }
+
+  if (autosave_path_.empty())
+  {
+    // Only check where to write the backup once; on a network mounted home
+    // directory these checks are as slow as the write itself.
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    QString default_path = QDir::homePath();
+
+    if (env.contains(ROS_WORKSPACE_VAR))
     {
-      ROS_WARN("Could not write config file to %s.  Trying home directory.",
-               (ws_path + MAPVIZ_CONFIG_FILE).toStdString().c_str());
+      // Try to save our config in the ROS_WORKSPACE directory, but if we can't write
+      // to that -- probably because it is read-only -- try to use the home directory
+      // instead.
+      QString ws_path = env.value(ROS_WORKSPACE_VAR, default_path);
+      QString ws_file = ws_path + MAPVIZ_CONFIG_FILE;
+      QFileInfo file_info(ws_file);
+      QFileInfo dir_info(ws_path);
+      if ((!file_info.exists() && dir_info.isWritable()) ||
+          file_info.isWritable())
+      {
+        // Note that FileInfo::isWritable will return false if a file does not exist, so
+        // we need to check both if the target file is writable and if the target dir is
+        // writable if the file doesn't exist.
+        default_path = ws_path;
+      }
+      else
+      {
+        ROS_WARN("Could not write config file to %s.  Trying home directory.",
+                 (ws_path + MAPVIZ_CONFIG_FILE).toStdString().c_str());
+      }
     }
+    default_path += MAPVIZ_CONFIG_FILE;
+
+    autosave_path_ = default_path.toStdString();
   }
-  default_path += MAPVIZ_CONFIG_FILE;
 
+  // Plugins don't share a common "config changed" signal, so the serialized
+  // config itself is compared against the last one written.  Serializing is
+  // cheap; only the file write is moved off of the GUI thread.
+  boost::filesystem::path filepath(autosave_path_);
+  std::string snapshot = SerializeConfig(filepath.parent_path().string());
+  if (snapshot == autosave_snapshot_)
+  {
+    return;
+  }
 
-  Save(default_path.toStdString());
+  autosave_snapshot_ = snapshot;
+  autosave_future_ = QtConcurrent::run(&Mapviz::WriteConfig, autosave_path_, snapshot);
 }
 
 void Mapviz::OpenConfig()
@@ -945,7 +1382,11 @@ void Mapviz::SelectNewDisplay()
   Ui::pluginselect ui;
   ui.setupUi(&dialog);
 
-  std::vector<std::string> plugins = loader_->getDeclaredClasses();
+  std::vector<std::string> plugins;
+  {
+    QMutexLocker locker(&loader_mutex_);
+    plugins = loader_->getDeclaredClasses();
+  }
   std::map<std::string, std::string> plugin_types;
   for (size_t i = 0; i < plugins.size(); i++)
   {
@@ -981,19 +1422,40 @@ bool Mapviz::AddDisplay(
       AddMapvizDisplay::Request& req,
       AddMapvizDisplay::Response& resp)
 {
-  std::map<std::string, std::string> properties;
-  for (auto& property: req.properties)
-  {
-    properties[property.key] = property.value;
-  }
+  MapvizDisplay display;
+  display.name = req.name;
+  display.type = req.type;
+  display.draw_order = req.draw_order;
+  display.visible = req.visible;
+  display.remove = false;
+  display.properties = req.properties;
 
-  YAML::Node config;
-  if (!swri_yaml_util::LoadMap(properties, config))
-  {
-    ROS_ERROR("Failed to parse properties into YAML.");
-    return false;
-  }
+  std::vector<MapvizDisplay> displays(1, display);
+  resp.success = ApplyDisplays(displays, resp.message);
+
+  return true;
+}
 
+bool Mapviz::ConfigureDisplays(
+      ConfigureMapvizDisplays::Request& req,
+      ConfigureMapvizDisplays::Response& resp)
+{
+  resp.success = ApplyDisplays(req.displays, resp.message);
+
+  return true;
+}
+
+bool Mapviz::ApplyDisplays(
+      const std::vector<MapvizDisplay>& displays,
+      std::string& message)
+{
+  // The displays may be part of a config that is still loading
+  FinishLoading();
+
+  // Index the existing displays by name and type once instead of scanning
+  // all of them for every request.
+  typedef std::pair<std::string, std::string> DisplayKey;
+  std::map<DisplayKey, QListWidgetItem*> index;
   for (auto& display: plugins_)
   {
     MapvizPluginPtr plugin = display.second;
@@ -1002,48 +1464,108 @@ bool Mapviz::AddDisplay(
       ROS_ERROR("Invalid plugin ptr.");
       continue;
     }
-    if (plugin->Name() == req.name && plugin->Type() ==req.type)
-    {
-      plugin->LoadConfig(config, "");
-      plugin->SetVisible(req.visible);
+    index.insert(std::make_pair(DisplayKey(plugin->Name(), plugin->Type()), display.first));
+  }
 
-      if (req.draw_order > 0)
+  std::vector<std::string> errors;
+  std::vector<std::pair<QListWidgetItem*, int32_t> > draw_orders;
+  for (const auto& display: displays)
+  {
+    DisplayKey key(display.name, ResolvePluginType(display.type));
+    std::map<DisplayKey, QListWidgetItem*>::iterator existing = index.find(key);
+
+    if (display.remove)
+    {
+      if (existing != index.end())
       {
-        display.first->setData(Qt::UserRole, QVariant(req.draw_order - 1.1));
-        ui_.configs->sortItems();
+        QListWidgetItem* item = existing->second;
+        for (size_t i = 0; i < draw_orders.size(); i++)
+        {
+          if (draw_orders[i].first == item)
+          {
+            draw_orders.erase(draw_orders.begin() + i);
+            i--;
+          }
+        }
+        index.erase(existing);
+        RemoveDisplay(item);
+      }
+      continue;
+    }
+
+    std::map<std::string, std::string> properties;
+    for (auto& property: display.properties)
+    {
+      properties[property.key] = property.value;
+    }
 
-        ReorderDisplays();
+    YAML::Node config;
+    if (!swri_yaml_util::LoadMap(properties, config))
+    {
+      ROS_ERROR("Failed to parse properties into YAML.");
+      errors.push_back("Failed to parse properties of " + display.name + " into YAML.");
+      continue;
+    }
+
+    QListWidgetItem* item = NULL;
+    if (existing != index.end())
+    {
+      item = existing->second;
+      MapvizPluginPtr plugin = plugins_[item];
+      plugin->LoadConfig(config, "");
+      plugin->SetVisible(display.visible);
+    }
+    else
+    {
+      try
+      {
+        // New displays are appended here and moved into place with the
+        // others once the whole batch has been applied.
+        MapvizPluginPtr plugin =
+          CreateNewDisplay(display.name, display.type, display.visible, false, 0, false);
+        plugin->LoadConfig(config, "");
+        plugin->DrawIcon();
+
+        item = ui_.configs->item(ui_.configs->count() - 1);
+        index[key] = item;
       }
-      else if (req.draw_order < 0)
+      catch (const pluginlib::PluginlibException& e)
       {
-        display.first->setData(Qt::UserRole, QVariant(ui_.configs->count() + req.draw_order + 0.1));
-        ui_.configs->sortItems();
-
-        ReorderDisplays();
+        ROS_ERROR("%s", e.what());
+        errors.push_back("Failed to load display plug-in for " + display.name + ".");
+        continue;
       }
+    }
 
-      resp.success = true;
-
-      return true;
+    if (display.draw_order != 0)
+    {
+      draw_orders.push_back(std::make_pair(item, display.draw_order));
     }
   }
 
-  try
+  if (!draw_orders.empty())
   {
-    MapvizPluginPtr plugin =
-      CreateNewDisplay(req.name, req.type, req.visible, false, req.draw_order);
-    plugin->LoadConfig(config, "");
-    plugin->DrawIcon();
-    resp.success = true;
-  }
-  catch (const pluginlib::LibraryLoadException& e)
-  {
-    ROS_ERROR("%s", e.what());
-    resp.success = false;
-    resp.message = "Failed to load display plug-in.";
+    ui_.configs->UpdateIndices();
+    for (const auto& draw_order: draw_orders)
+    {
+      if (draw_order.second > 0)
+      {
+        draw_order.first->setData(Qt::UserRole, QVariant(draw_order.second - 1.1));
+      }
+      else
+      {
+        draw_order.first->setData(Qt::UserRole, QVariant(ui_.configs->count() + draw_order.second + 0.1));
+      }
+    }
+    ui_.configs->sortItems();
+    ui_.configs->UpdateIndices();
   }
 
-  return true;
+  ReorderDisplays();
+  canvas_->UpdateView();
+
+  message = boost::algorithm::join(errors, "\n");
+  return errors.empty();
 }
 
 void Mapviz::Hover(double x, double y, double scale)
@@ -1130,24 +1652,22 @@ MapvizPluginPtr Mapviz::CreateNewDisplay(
     const std::string& type,
     bool visible,
     bool collapsed,
-    int draw_order)
+    int draw_order,
+    bool reorder)
 {
   ConfigItem* config_item = new ConfigItem();
 
   config_item->SetName(name.c_str());
 
-  std::string real_type = type;
-  if (real_type == "mapviz_plugins/mutlires_image")
-  {
-    // The "multires_image" plugin was originally accidentally named "mutlires_image".
-    // Loading a mapviz config file that still has the old name would normally cause it
-    // to crash, so this will check for and correct it.
-    real_type = "mapviz_plugins/multires_image";
-  }
-
+  std::string real_type = ResolvePluginType(type);
 
   ROS_INFO("creating: %s", real_type.c_str());
-  MapvizPluginPtr plugin = loader_->createInstance(real_type.c_str());
+  ScopedStartupPhase phase("Construction", name);
+  MapvizPluginPtr plugin;
+  {
+    QMutexLocker locker(&loader_mutex_);
+    plugin = loader_->createInstance(real_type.c_str());
+  }
 
   // Setup configure widget
   config_item->SetWidget(plugin->GetConfigWidget(this));
@@ -1215,7 +1735,10 @@ MapvizPluginPtr Mapviz::CreateNewDisplay(
   if (collapsed)
     config_item->Hide();
 
-  ReorderDisplays();
+  if (reorder)
+  {
+    ReorderDisplays();
+  }
 
   return plugin;
 }
@@ -1486,6 +2009,11 @@ void Mapviz::RemoveDisplay(QListWidgetItem* item)
 
 void Mapviz::ClearDisplays()
 {
+  load_timer_.stop();
+  pending_displays_.clear();
+  failed_plugins_.clear();
+  ReleaseSnapshot();
+
   while (ui_.configs->count() > 0)
   {
     ROS_INFO("Remove display ...");
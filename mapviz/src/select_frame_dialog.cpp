@@ -37,10 +37,11 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QLabel>
-#include <QTimerEvent>
 
 #include <tf/transform_listener.h>
 
+#include <mapviz/discovery_service.h>
+
 namespace mapviz
 {
 std::string SelectFrameDialog::selectFrame(
@@ -108,22 +109,18 @@ SelectFrameDialog::SelectFrameDialog(
 
   resize(600, 600);
   
-  fetch_frames_timer_id_ = startTimer(1000);
+  // The frame list is polled from TF by the shared discovery service,
+  // which only notifies us when it changes.
+  DiscoveryService& discovery = DiscoveryService::Instance();
+  connect(&discovery, SIGNAL(FramesChanged()),
+          this, SLOT(fetchFrames()));
+  discovery.WatchFrames();
   fetchFrames();
 }
 
-void SelectFrameDialog::timerEvent(QTimerEvent *event)
-{  
-  if (event->timerId() == fetch_frames_timer_id_) {
-    fetchFrames();
-  }
-}
-
-void SelectFrameDialog::closeEvent(QCloseEvent *event)
+SelectFrameDialog::~SelectFrameDialog()
 {
-  // We don't need to keep making requests from the ROS master.
-  killTimer(fetch_frames_timer_id_);
-  QDialog::closeEvent(event);
+  DiscoveryService::Instance().UnwatchFrames();
 }
 
 void SelectFrameDialog::allowMultipleFrames(
@@ -171,10 +168,8 @@ std::vector<std::string> SelectFrameDialog::selectedFrames() const
 void SelectFrameDialog::fetchFrames()
 {
   if (!tf_) { return; }
-  
-  known_frames_.clear();
-  tf_->getFrameStrings(known_frames_);
-  std::sort(known_frames_.begin(), known_frames_.end());
+
+  known_frames_ = DiscoveryService::Instance().Frames();
   updateDisplayedFrames();
 }
 
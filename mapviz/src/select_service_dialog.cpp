@@ -30,71 +30,21 @@
 
 #include <mapviz/select_service_dialog.h>
 
-#include <QCloseEvent>
+#include <algorithm>
+#include <iterator>
+
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QListWidget>
 #include <QMessageBox>
 #include <QPushButton>
-#include <QTimerEvent>
 #include <QVBoxLayout>
 
-#include <rosapi/Services.h>
-#include <rosapi/ServicesForType.h>
+#include <mapviz/discovery_service.h>
 
 namespace mapviz
 {
-  void ServiceUpdaterThread::run()
-  {
-    ros::ServiceClient client;
-
-    if (allowed_datatype_.empty())
-    {
-      client = nh_.serviceClient<rosapi::Services>("/rosapi/services");
-    }
-    else
-    {
-      client = nh_.serviceClient<rosapi::ServicesForType>("/rosapi/services_for_type");
-    }
-
-    if (!client.waitForExistence(ros::Duration(1)))
-    {
-      // Check to see whether the rosapi services are actually running.
-      Q_EMIT fetchingFailed(tr("Unable to list ROS services.  Is rosapi_node running?"));
-      return;
-    }
-
-    if (allowed_datatype_.empty())
-    {
-      rosapi::Services srv;
-
-      ROS_DEBUG("Listing all services.");
-      if (client.call(srv))
-      {
-        Q_EMIT servicesFetched(srv.response.services);
-      }
-    }
-    else {
-      rosapi::ServicesForType srv;
-      srv.request.type = allowed_datatype_;
-
-      ROS_DEBUG("Listing services for type %s", srv.request.type.c_str());
-      if (client.call(srv))
-      {
-        Q_EMIT servicesFetched(srv.response.services);
-      }
-      else
-      {
-        // If there are any dead or unreachable nodes that provide services, even if
-        // they're not of the service type we're looking for, the services_for_type
-        // service will have an error and not return anything.  Super annoying.
-        Q_EMIT fetchingFailed(tr("Unable to list ROS services.  You may have " \
-                              "dead nodes; try running \"rosnode cleanup\"."));
-      }
-    }
-  }
-
   std::string SelectServiceDialog::selectService(const std::string& datatype, QWidget* parent)
   {
     SelectServiceDialog dialog(datatype, parent);
@@ -110,6 +60,7 @@ namespace mapviz
       :
       QDialog(parent),
       allowed_datatype_(datatype),
+      error_shown_(false),
       cancel_button_(new QPushButton("&Cancel")),
       list_widget_(new QListWidget()),
       name_filter_(new QLineEdit()),
@@ -130,10 +81,6 @@ namespace mapviz
     vbox->addLayout(button_box);
     setLayout(vbox);
 
-    // This is ugly, but necessary in order to be able to send a std::vector<std::string>
-    // via a queued signal/slot connection.
-    qRegisterMetaType<ServiceStringVector>("ServiceStringVector");
-
     connect(ok_button_, SIGNAL(clicked(bool)),
             this, SLOT(accept()));
     connect(cancel_button_, SIGNAL(clicked(bool)),
@@ -145,55 +92,40 @@ namespace mapviz
 
     setWindowTitle("Select service...");
 
-    fetch_services_timer_id_ = startTimer(5000);
-    fetchServices();
+    DiscoveryService& discovery = DiscoveryService::Instance();
+    connect(&discovery, SIGNAL(ServicesChanged(const QString&)),
+            this, SLOT(updateKnownServices(const QString&)));
+    connect(&discovery, SIGNAL(ServiceDiscoveryFailed(const QString&, const QString&)),
+            this, SLOT(displayUpdateError(const QString&, const QString&)));
+    discovery.WatchServices(allowed_datatype_);
+    known_services_ = discovery.Services(allowed_datatype_);
+    updateDisplayedServices();
   }
 
   SelectServiceDialog::~SelectServiceDialog()
   {
-    if (worker_thread_)
-    {
-      // If the thread's parent is destroyed before the thread has finished,
-      // it will cause a segmentation fault.  We'll wait a few seconds for
-      // it to finish cleanly, and if that doesn't work, try to force it to
-      // die and wait a few more.
-      worker_thread_->wait(5000);
-      if (worker_thread_->isRunning())
-      {
-        worker_thread_->terminate();
-        worker_thread_->wait(2000);
-      }
-    }
+    DiscoveryService::Instance().UnwatchServices(allowed_datatype_);
   }
 
-  void SelectServiceDialog::fetchServices()
+  void SelectServiceDialog::updateKnownServices(const QString& datatype)
   {
-    // If we don't currently have a worker thread or the previous one has
-    // finished, start a new one.
-    if (!worker_thread_ || worker_thread_->isFinished())
+    if (datatype.toStdString() != allowed_datatype_)
     {
-      worker_thread_.reset(new ServiceUpdaterThread(nh_, allowed_datatype_, this));
-      QObject::connect(worker_thread_.get(),
-                       SIGNAL(servicesFetched(ServiceStringVector)),
-                       this,
-                       SLOT(updateKnownServices(ServiceStringVector)));
-      QObject::connect(worker_thread_.get(),
-                       SIGNAL(fetchingFailed(const QString)),
-                       this,
-                       SLOT(displayUpdateError(const QString)));
-      worker_thread_->start();
+      return;
     }
-  }
 
-  void SelectServiceDialog::updateKnownServices(ServiceStringVector services)
-  {
-    known_services_ = services;
+    known_services_ = DiscoveryService::Instance().Services(allowed_datatype_);
     updateDisplayedServices();
   }
 
-  void SelectServiceDialog::displayUpdateError(const QString error_msg)
+  void SelectServiceDialog::displayUpdateError(const QString& datatype, const QString& error_msg)
   {
-    killTimer(fetch_services_timer_id_);
+    if (error_shown_ || datatype.toStdString() != allowed_datatype_)
+    {
+      return;
+    }
+
+    error_shown_ = true;
     QMessageBox mbox(this->parentWidget());
     mbox.setIcon(QMessageBox::Warning);
     mbox.setText(error_msg);
@@ -275,7 +207,14 @@ namespace mapviz
 
   void SelectServiceDialog::setDatatypeFilter(const std::string& datatype)
   {
-    allowed_datatype_ = datatype;
+    if (datatype != allowed_datatype_)
+    {
+      DiscoveryService& discovery = DiscoveryService::Instance();
+      discovery.UnwatchServices(allowed_datatype_);
+      allowed_datatype_ = datatype;
+      discovery.WatchServices(allowed_datatype_);
+      known_services_ = discovery.Services(allowed_datatype_);
+    }
     updateDisplayedServices();
   }
 
@@ -292,18 +231,4 @@ namespace mapviz
 
     return "";
   }
-
-  void SelectServiceDialog::timerEvent(QTimerEvent* event)
-  {
-      if (event->timerId() == fetch_services_timer_id_) {
-        fetchServices();
-      }
-  }
-
-  void SelectServiceDialog::closeEvent(QCloseEvent* event)
-  {
-    // We don't need to keep making requests from the ROS master.
-    killTimer(fetch_services_timer_id_);
-    QDialog::closeEvent(event);
-  }
 }
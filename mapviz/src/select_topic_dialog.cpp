@@ -36,7 +36,8 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QLabel>
-#include <QTimerEvent>
+
+#include <mapviz/discovery_service.h>
 
 namespace mapviz
 {
@@ -142,22 +143,19 @@ SelectTopicDialog::SelectTopicDialog(QWidget *parent)
   allowMultipleTopics(false);
   setWindowTitle("Select topics...");
 
-  fetch_topics_timer_id_ = startTimer(1000);
+  // The topic list is polled from the master by the shared discovery
+  // service, which only notifies us when it changes.
+  DiscoveryService& discovery = DiscoveryService::Instance();
+  connect(&discovery, SIGNAL(TopicsChanged()),
+          this, SLOT(fetchTopics()));
+  discovery.WatchTopics();
   fetchTopics();
 }
 
-void SelectTopicDialog::timerEvent(QTimerEvent *event)
-{
-  if (event->timerId() == fetch_topics_timer_id_) {
-    fetchTopics();
-  }
-}
-
-void SelectTopicDialog::closeEvent(QCloseEvent *event)
+SelectTopicDialog::~SelectTopicDialog()
 {
   // We don't need to keep making requests from the ROS master.
-  killTimer(fetch_topics_timer_id_);
-  QDialog::closeEvent(event);
+  DiscoveryService::Instance().UnwatchTopics();
 }
 
 void SelectTopicDialog::allowMultipleTopics(
@@ -212,16 +210,9 @@ std::vector<ros::master::TopicInfo> SelectTopicDialog::selectedTopics() const
   return selection;
 }
 
-static bool topicSort(const ros::master::TopicInfo &info1,
-                      const ros::master::TopicInfo &info2)
-{
-  return info1.name < info2.name;
-}
-
 void SelectTopicDialog::fetchTopics()
 {
-  ros::master::getTopics(known_topics_);
-  std::sort(known_topics_.begin(), known_topics_.end(), topicSort);
+  known_topics_ = DiscoveryService::Instance().Topics();
   updateDisplayedTopics();
 }
 
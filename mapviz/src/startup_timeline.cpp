@@ -0,0 +1,238 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz/startup_timeline.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <ros/console.h>
+
+namespace mapviz
+{
+static std::string EscapeJson(const std::string& value)
+{
+  std::string escaped;
+  for (size_t i = 0; i < value.size(); i++)
+  {
+    char c = value[i];
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char code[8];
+      snprintf(code, sizeof(code), "\\u%04x", c);
+      escaped += code;
+    }
+    else
+    {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+StartupTimeline& StartupTimeline::Instance()
+{
+  static StartupTimeline instance;
+  return instance;
+}
+
+StartupTimeline::StartupTimeline() :
+  finished_(false)
+{
+}
+
+void StartupTimeline::Record(
+    const std::string& phase,
+    const std::string& display,
+    const ros::WallTime& start,
+    const ros::WallTime& end)
+{
+  QCoreApplication* app = QCoreApplication::instance();
+
+  Interval interval;
+  interval.phase = phase;
+  interval.display = display;
+  interval.start = start;
+  interval.end = end;
+  interval.main_thread = app == NULL || QThread::currentThread() == app->thread();
+
+  boost::mutex::scoped_lock lock(mutex_);
+  if (!finished_)
+  {
+    intervals_.push_back(interval);
+  }
+}
+
+bool StartupTimeline::Finish()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  bool was_finished = finished_;
+  finished_ = true;
+  return !was_finished;
+}
+
+bool StartupTimeline::Finished() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return finished_;
+}
+
+void StartupTimeline::PrintReport() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  if (intervals_.empty())
+  {
+    return;
+  }
+
+  ros::WallTime origin = intervals_.front().start;
+  for (const auto& interval: intervals_)
+  {
+    origin = std::min(origin, interval.start);
+  }
+
+  // Displays are listed by how long they blocked the GUI thread, slowest
+  // first, since those are the ones worth trimming from a config.
+  std::vector<std::string> displays;
+  std::map<std::string, std::map<std::string, ros::WallDuration> > durations;
+  std::map<std::string, double> ready;
+  std::map<std::string, double> blocking;
+  ROS_INFO("Startup timeline:");
+  for (const auto& interval: intervals_)
+  {
+    ros::WallDuration duration = interval.end - interval.start;
+    if (interval.display.empty() || interval.phase == "Library load")
+    {
+      ROS_INFO("  %-16s %-40s at %8.1fms, took %8.1fms",
+               interval.phase.c_str(),
+               interval.display.c_str(),
+               (interval.start - origin).toSec() * 1000.0,
+               duration.toSec() * 1000.0);
+      continue;
+    }
+
+    if (durations.find(interval.display) == durations.end())
+    {
+      displays.push_back(interval.display);
+    }
+    durations[interval.display][interval.phase] += duration;
+    if (interval.phase == "First draw")
+    {
+      ready[interval.display] = (interval.end - origin).toSec() * 1000.0;
+    }
+    if (interval.phase != "Waiting for data")
+    {
+      blocking[interval.display] += duration.toSec() * 1000.0;
+    }
+  }
+
+  std::stable_sort(displays.begin(), displays.end(),
+    [&blocking](const std::string& a, const std::string& b)
+    {
+      return blocking[a] > blocking[b];
+    });
+
+  ROS_INFO("  %-24s %12s %12s %12s %12s %12s", "Display",
+           "Construct", "LoadConfig", "Data after", "First draw", "Shown at");
+  for (const auto& display: displays)
+  {
+    std::map<std::string, ros::WallDuration>& phases = durations[display];
+    char shown[32] = "--";
+    if (ready.find(display) != ready.end())
+    {
+      snprintf(shown, sizeof(shown), "%10.1fms", ready[display]);
+    }
+    char data[32] = "--";
+    if (phases.find("Waiting for data") != phases.end())
+    {
+      snprintf(data, sizeof(data), "%10.1fms", phases["Waiting for data"].toSec() * 1000.0);
+    }
+    char draw[32] = "--";
+    if (phases.find("First draw") != phases.end())
+    {
+      snprintf(draw, sizeof(draw), "%10.1fms", phases["First draw"].toSec() * 1000.0);
+    }
+    ROS_INFO("  %-24s %10.1fms %10.1fms %12s %12s %12s",
+             display.c_str(),
+             phases["Construction"].toSec() * 1000.0,
+             phases["LoadConfig"].toSec() * 1000.0,
+             data,
+             draw,
+             shown);
+  }
+}
+
+bool StartupTimeline::WriteTrace(const std::string& filename) const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == NULL)
+  {
+    ROS_ERROR("Failed to open startup trace: %s", filename.c_str());
+    return false;
+  }
+
+  // Complete ("X") events with microsecond timestamps; the library loads
+  // run on a worker thread and get their own track.
+  fprintf(file, "{\"traceEvents\":[\n");
+  for (size_t i = 0; i < intervals_.size(); i++)
+  {
+    const Interval& interval = intervals_[i];
+    std::string name = interval.display.empty() ?
+        interval.phase : interval.phase + ": " + interval.display;
+    fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,\"pid\":1,\"tid\":%d}",
+            i == 0 ? "" : ",\n",
+            EscapeJson(name).c_str(),
+            EscapeJson(interval.phase).c_str(),
+            interval.start.toSec() * 1.0e6,
+            (interval.end - interval.start).toSec() * 1.0e6,
+            interval.main_thread ? 1 : 2);
+  }
+  fprintf(file, "\n]}\n");
+
+  bool success = !ferror(file);
+  if (fclose(file) != 0 || !success)
+  {
+    ROS_ERROR("Failed to write startup trace: %s", filename.c_str());
+    return false;
+  }
+
+  ROS_INFO("Wrote startup trace to %s", filename.c_str());
+  return true;
+}
+}  // namespace mapviz
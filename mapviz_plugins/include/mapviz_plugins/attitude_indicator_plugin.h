@@ -42,6 +42,7 @@
 #include <QColor>
 #include <QGLWidget>
 #include <QObject>
+#include <QPicture>
 #include <QWidget>
 
 // ROS libraries
@@ -80,16 +81,22 @@ class AttitudeIndicatorPlugin : public mapviz::MapvizPlugin
 
   QWidget* GetConfigWidget(QWidget* parent);
 
+  bool SupportsHud()
+  {
+    return true;
+  }
+
+  QRect HudRect();
+  void PaintHud(QPainter* painter, const QSize& size);
+
  protected:
   void PrintError(const std::string& message);
   void PrintInfo(const std::string& message);
   void PrintWarning(const std::string& message);
 
-  void drawBackground();
-  void drawBall();
-  void drawPanel();
-  
-  void timerEvent(QTimerEvent *);
+  void buildBackground();
+  void buildPanel();
+  void drawBall(QPainter* painter);
 
  protected Q_SLOTS:
    void SelectTopic();
@@ -105,6 +112,11 @@ class AttitudeIndicatorPlugin : public mapviz::MapvizPlugin
   double pitch_;
   double roll_;
   double yaw_;
+
+  // The parts of the indicator that never change, recorded once in the
+  // [-1, 1]x[-1, 1] unit square with y pointing up.
+  QPicture background_;
+  QPicture panel_;
   PlaceableWindowProxy placer_;
   QWidget* config_widget_;
   ros::Subscriber odometry_sub_;
@@ -35,6 +35,8 @@
 #include <vector>
 
 #include <mapviz/mapviz_plugin.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
+#include <mapviz_plugins/vertex_picker.h>
 
 // QT libraries
 #include <QGLWidget>
@@ -88,6 +90,9 @@ namespace mapviz_plugins
     bool handleMouseRelease(QMouseEvent *);
     bool handleMouseMove(QMouseEvent *);
 
+    bool UpdateTransformedVertices();
+    void MoveVertex(int index, const QPointF& point);
+
    protected Q_SLOTS:
     void PublishPolygon();
     void Clear();
@@ -103,7 +108,17 @@ namespace mapviz_plugins
     ros::Publisher polygon_pub_;
 
     std::vector<tf::Vector3> vertices_;
+
+    // The vertices in the target frame, along with their vertex buffer and
+    // picking index.  They are recomputed only when the vertices are edited
+    // or the transform changes.
     std::vector<tf::Vector3> transformed_vertices_;
+    bool vertices_dirty_;
+    swri_transform_util::Transform transform_;
+    std::vector<tf::Vector3> probe_points_;
+    std::vector<tf::Vector3> probes_;
+    PathVertexBuffer vertex_buffer_;
+    VertexPicker picker_;
 
     int selected_point_;
     bool is_mouse_down_;
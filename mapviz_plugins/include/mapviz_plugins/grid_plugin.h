@@ -32,7 +32,7 @@
 
 // C++ standard libraries
 #include <string>
-#include <list>
+#include <vector>
 
 #include <mapviz/mapviz_plugin.h>
 
@@ -103,20 +103,37 @@ namespace mapviz_plugins
 
     bool transformed_;
 
-    std::list<tf::Point> top_points_;
-    std::list<tf::Point> bottom_points_;
-    std::list<tf::Point> left_points_;
-    std::list<tf::Point> right_points_;
-
-    std::list<tf::Point> transformed_top_points_;
-    std::list<tf::Point> transformed_bottom_points_;
-    std::list<tf::Point> transformed_left_points_;
-    std::list<tf::Point> transformed_right_points_;
-
     swri_transform_util::Transform transform_;
 
-    void RecalculateGrid();
-    void Transform(std::list<tf::Point>& src, std::list<tf::Point>& dst);
+    // Transforms from /wgs84 only have an origin, so they can't be applied
+    // as a model matrix.  The grid is then clipped through the inverse
+    // transform and its line endpoints are transformed one by one.
+    bool rigid_;
+    swri_transform_util::Transform inverse_transform_;
+
+    // Line endpoints in the grid's frame (the target frame for non-rigid
+    // transforms), rebuilt every frame from the lines that are actually in
+    // view.
+    std::vector<double> major_vertices_;
+    std::vector<double> minor_vertices_;
+
+    void AddLines(
+        std::vector<double>& vertices,
+        bool vertical,
+        double view_min,
+        double view_max,
+        double line_min,
+        double line_max,
+        int64_t step,
+        int64_t skip_step);
+    void AddLine(
+        std::vector<double>& vertices,
+        bool vertical,
+        double position,
+        double line_min,
+        double line_max);
+    void DrawLines(const std::vector<double>& vertices, double width, double alpha);
+    void TransformVertices(std::vector<double>& vertices);
   };
 }
 
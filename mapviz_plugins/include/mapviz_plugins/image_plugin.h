@@ -94,6 +94,14 @@ namespace mapviz_plugins
 
     QWidget* GetConfigWidget(QWidget* parent);
 
+    bool SupportsHud()
+    {
+      return true;
+    }
+
+    QRect HudRect();
+    void PaintHud(QPainter* painter, const QSize& size);
+
   protected:
     void PrintError(const std::string& message);
     void PrintInfo(const std::string& message);
@@ -143,11 +151,11 @@ namespace mapviz_plugins
 
     cv_bridge::CvImagePtr cv_image_;
     cv::Mat scaled_image_;
+    QRect hud_rect_;
 
     void imageCallback(const sensor_msgs::ImageConstPtr& image);
 
     void ScaleImage(double width, double height);
-    void DrawIplImage(cv::Mat *image);
 
     std::string AnchorToString(Anchor anchor);
     std::string UnitsToString(Units units);
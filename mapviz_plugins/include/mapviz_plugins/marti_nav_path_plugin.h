@@ -30,9 +30,9 @@
 #ifndef MAPVIZ_PLUGINS_MARTI_NAV_PATH_PLUGIN_H_
 #define MAPVIZ_PLUGINS_MARTI_NAV_PATH_PLUGIN_H_
 
+#include <deque>
 #include <string>
-
-#include <boost/circular_buffer.hpp>
+#include <vector>
 
 #include <mapviz/mapviz_plugin.h>
 
@@ -45,6 +45,7 @@
 #include <mapviz/mapviz_plugin.h>
 
 #include <marti_nav_msgs/Path.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
 
 #include <topic_tools/shape_shifter.h>
 
@@ -62,11 +63,31 @@ class MartiNavPathPlugin : public mapviz::MapvizPlugin
 
   ros::Subscriber subscriber_;
 
-  boost::circular_buffer<marti_nav_msgs::Path> items_;
+
+  // Each path in the history is kept in its own frame with persistent
+  // vertex buffers for its points and its yaw arrows.
+  struct PathGeometry
+  {
+    std::string frame;
+    bool in_reverse;
+    marti_nav_msgs::Path path;
+    double arrow_length;
+    PathVertexBuffer points;
+    PathVertexBuffer arrows;
+
+    // Transforms from /wgs84 can't be applied as a model matrix, so the
+    // buffers then hold the path transformed into the target frame.  The
+    // probes tell when it has to be transformed again.
+    bool points_transformed;
+    bool arrows_transformed;
+    std::vector<tf::Vector3> probes;
+  };
+  std::deque<boost::shared_ptr<PathGeometry> > items_;
 
 public:
 
   MartiNavPathPlugin();
+  virtual ~MartiNavPathPlugin();
 
   bool Initialize(QGLWidget* canvas);
   void Shutdown();
@@ -85,6 +106,8 @@ protected:
   void PrintError(const std::string& message);
 
   void setColorForDirection(const bool in_reverse);
+  void updatePoints(PathGeometry& item, const swri_transform_util::Transform* transform);
+  void updateArrows(PathGeometry& item, const swri_transform_util::Transform* transform);
 
   // Callbacks and helpers for them
   void messageCallback(const topic_tools::ShapeShifter::ConstPtr& msg);
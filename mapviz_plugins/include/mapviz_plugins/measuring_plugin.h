@@ -31,6 +31,8 @@
 #define MAPVIZ_PLUGINS_MEASURING_PLUGIN_H_
 
 #include <mapviz/mapviz_plugin.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
+#include <mapviz_plugins/vertex_picker.h>
 
 // ROS Libraries
 #include <ros/ros.h>
@@ -80,6 +82,7 @@ namespace mapviz_plugins
       bool handleMousePress(QMouseEvent*);
       bool handleMouseRelease(QMouseEvent*);
       bool handleMouseMove(QMouseEvent*);
+      void VerticesEdited();
 
     protected Q_SLOTS:
       void Clear();
@@ -96,7 +99,10 @@ namespace mapviz_plugins
       tf::Vector3 last_position_;
 
       std::vector<tf::Vector3> vertices_;
-      std::vector<tf::Vector3> transformed_vertices_;
+
+      // Rebuilt only when the vertices are edited.
+      PathVertexBuffer vertex_buffer_;
+      VertexPicker picker_;
 
       int selected_point_;
       bool is_mouse_down_;
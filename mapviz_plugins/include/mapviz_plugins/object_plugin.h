@@ -31,12 +31,17 @@
 #define MAPVIZ_PLUGINS_OBJECT_PLUGIN_H_
 
 // C++ standard libraries
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <mapviz/mapviz_plugin.h>
 
 // QT libraries
 #include <QGLWidget>
+#include <QPixmap>
+#include <QRect>
 
 // ROS libraries
 #include <tf/transform_datatypes.h>
@@ -91,30 +96,34 @@ namespace mapviz_plugins
     void SetColor(const QColor& color);
 
   private:
-    struct Color
+    // Objects with the same frame and stamp share a transform, so TF is
+    // only queried once per group; a group's vertices are only transformed
+    // again when its transform changes.
+    struct ObjectGroup
     {
-      float r, g, b, a;
-    };
+      std::string source_frame;
+      ros::Time stamp;
 
-    struct StampedPoint
-    {
-      tf::Point point;
+      std::vector<size_t> objects;
 
-      tf::Point transformed_point;
+      bool transformed;
+      tf::Vector3 probes[3];
     };
 
+    // Each object's polygon is a closed line strip in the shared vertex
+    // buffer; its bounds are in the target frame and are used for culling.
     struct ObjectData
     {
-      ros::Time stamp;
-
-      std::vector<StampedPoint> polygon;
       std::string id;
-
-      std::string source_frame;
-      swri_transform_util::Transform local_transform;
-      
-      bool transformed;
       bool active;
+      size_t group;
+
+      GLint first;
+      GLsizei count;
+
+      double min_x, min_y, max_x, max_y;
+
+      QRect label;
     };
 
     Ui::object_config ui_;
@@ -127,11 +136,44 @@ namespace mapviz_plugins
     bool connected_;
     bool has_message_;
 
+    std::vector<ObjectGroup> groups_;
+    std::map<std::pair<std::string, ros::Time>, size_t> group_index_;
     std::vector<ObjectData> objects_;
 
+    // Polygon points in their source frames, and the transformed vertices
+    // relative to vertex_origin_ to keep single precision accurate.
+    std::vector<tf::Point> points_;
+    std::vector<float> vertices_;
+    std::string vertex_frame_;
+    bool has_vertex_origin_;
+    tf::Point vertex_origin_;
+
+    GLuint vbo_;
+    bool vertices_dirty_;
+
+    // Objects that were in view during the last Draw(), which Paint() uses
+    // to draw their labels.
+    std::vector<size_t> visible_objects_;
+    std::vector<GLint> draw_firsts_;
+    std::vector<GLsizei> draw_counts_;
+
+    // All of the ids of the current message are rendered into one pixmap,
+    // which labels are drawn from as fragments.
+    QPixmap label_atlas_;
+    bool labels_dirty_;
+
     void handleMessage(const topic_tools::ShapeShifter::ConstPtr& msg);
     void handleTrack(const marti_nav_msgs::TrackedObject& obj);
     void handleObstacle(const marti_nav_msgs::Obstacle& obj, const std_msgs::Header& header);
+    template <class PointT>
+    void addObject(
+        const std::string& id,
+        bool active,
+        const std_msgs::Header& header,
+        const geometry_msgs::Pose& pose,
+        const std::vector<PointT>& polygon);
+    void clearObjects();
+    void updateLabelAtlas();
   };
 }
 
@@ -75,6 +75,9 @@ namespace mapviz_plugins
     void LoadConfig(const YAML::Node& node, const std::string& path);
     void SaveConfig(YAML::Emitter& emitter, const std::string& path);
 
+    bool SaveSnapshot(std::vector<uint8_t>& buffer) const;
+    void LoadSnapshot(const uint8_t* data, size_t size);
+
     QWidget* GetConfigWidget(QWidget* parent);
 
   protected:
@@ -32,14 +32,18 @@
 
 // C++ standard libraries
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
 #include <mapviz/mapviz_plugin.h>
 #include <mapviz_plugins/point_drawing_plugin.h>
 // QT libraries
+#include <QFont>
 #include <QGLWidget>
 #include <QObject>
+#include <QSizeF>
+#include <QStaticText>
 #include <QWidget>
 
 // ROS libraries
@@ -96,6 +100,12 @@ namespace mapviz_plugins
     std::string topic_;
     ros::Subscriber odometry_sub_;
     bool has_message_;
+
+    // Timestamp labels are laid out once per point and reused on every frame
+    QFont timestamp_font_;
+    QSizeF timestamp_cell_;
+    std::map<ros::Time, QStaticText> timestamp_labels_;
+
     void odometryCallback(const nav_msgs::OdometryConstPtr odometry);
   };
 }
@@ -33,6 +33,7 @@
 // C++ standard libraries
 #include <string>
 #include <list>
+#include <vector>
 
 #include <mapviz/mapviz_plugin.h>
 
@@ -45,8 +46,10 @@
 #include <ros/ros.h>
 #include <tf/transform_datatypes.h>
 #include <nav_msgs/Path.h>
+#include <swri_transform_util/transform.h>
 
 #include <mapviz/map_canvas.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
 #include <mapviz_plugins/point_drawing_plugin.h>
 
 // QT autogenerated files
@@ -69,9 +72,14 @@ namespace mapviz_plugins
 
     void Draw(double x, double y, double scale);
 
+    void Transform();
+
     void LoadConfig(const YAML::Node& node, const std::string& path);
     void SaveConfig(YAML::Emitter& emitter, const std::string& path);
 
+    bool SaveSnapshot(std::vector<uint8_t>& buffer) const;
+    void LoadSnapshot(const uint8_t* data, size_t size);
+
     QWidget* GetConfigWidget(QWidget* parent);
 
    protected:
@@ -91,6 +99,22 @@ namespace mapviz_plugins
 
     ros::Subscriber path_sub_;
     bool has_message_;
+    nav_msgs::PathConstPtr path_;
+
+    // The path's points in its own frame.  The buffer holds them as they
+    // are when the transform is rigid, or transformed into the target frame
+    // when it isn't (e.g. from /wgs84); the probes tell when the
+    // transformed points have to be rebuilt.
+    std::vector<tf::Point> points_;
+    PathVertexBuffer path_buffer_;
+    bool points_dirty_;
+    bool buffer_transformed_;
+    std::vector<tf::Vector3> probes_;
+
+    bool transformed_;
+    swri_transform_util::Transform transform_;
+    std::string transform_target_;
+    ros::Time stamp_;
 
     void pathCallback(const nav_msgs::PathConstPtr& path);
   };
@@ -0,0 +1,111 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_PLUGINS_PATH_VERTEX_BUFFER_H_
+#define MAPVIZ_PLUGINS_PATH_VERTEX_BUFFER_H_
+
+// C++ standard libraries
+#include <cstddef>
+#include <vector>
+
+// QT libraries
+#include <QGLWidget>
+
+// ROS libraries
+#include <tf/transform_datatypes.h>
+
+namespace mapviz_plugins
+{
+  /**
+   * Keeps the vertices of a path in a persistent vertex buffer.
+   *
+   * When the vertices are replaced, only the range that differs from the
+   * previous contents (everything between the unchanged prefix and the
+   * unchanged suffix) is uploaded on the next draw.  Vertices are grouped
+   * into fixed size chunks with bounding boxes so that chunks outside of the
+   * view can be skipped.
+   *
+   * Vertices are stored relative to the first vertex ever set, which keeps
+   * single precision coordinates accurate for paths far from their frame's
+   * origin.  All GL calls happen in Draw() or the destructor.
+   */
+  class PathVertexBuffer
+  {
+  public:
+    PathVertexBuffer();
+    ~PathVertexBuffer();
+
+    /**
+     * Replaces the contents of the buffer.  Only the x and y components of
+     * the points are used.
+     */
+    void SetVertices(const std::vector<tf::Point>& points);
+
+    void Clear();
+
+    size_t Size() const { return vertices_.size() / 2; }
+
+    /**
+     * Draws the vertices with the given primitive mode.  Chunks that don't
+     * intersect the circle at (x, y) with the given radius are skipped; all
+     * values are in the same frame as the vertices.  GL_LINE_STRIP,
+     * GL_LINES and GL_POINTS are supported.
+     */
+    void Draw(GLenum mode, double x, double y, double radius);
+
+  private:
+    struct Bounds
+    {
+      float min_x;
+      float min_y;
+      float max_x;
+      float max_y;
+    };
+
+    void UpdateBounds(size_t first_chunk, size_t last_chunk);
+
+    // Vertices per culling chunk; a multiple of 6 so that chunks never split
+    // a line segment or an arrow.
+    static const size_t CHUNK_SIZE = 252;
+
+    bool has_origin_;
+    tf::Point origin_;
+
+    std::vector<float> vertices_;
+    std::vector<Bounds> bounds_;
+
+    GLuint vbo_;
+    size_t capacity_;
+    bool dirty_;
+    size_t dirty_begin_;
+    size_t dirty_end_;
+  };
+}
+
+#endif  // MAPVIZ_PLUGINS_PATH_VERTEX_BUFFER_H_
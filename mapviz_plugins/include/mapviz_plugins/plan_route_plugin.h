@@ -37,6 +37,7 @@
 #include <mapviz/mapviz_plugin.h>
 
 // QT libraries
+#include <QFutureWatcher>
 #include <QGLWidget>
 #include <QObject>
 #include <QWidget>
@@ -51,6 +52,7 @@
 
 // Messages
 #include <geometry_msgs/Pose.h>
+#include <marti_nav_msgs/PlanRoute.h>
 #include <marti_nav_msgs/Route.h>
 
 // QT autogenerated files
@@ -101,10 +103,26 @@ namespace mapviz_plugins
     void PlanRoute();
     void Clear();
     void VisibilityChanged(bool);
+    void HandlePlanResult();
 
    private:
+    struct PlanResult
+    {
+      bool called;
+      marti_nav_msgs::PlanRoute::Response response;
+    };
+
+    static PlanResult CallPlanner(
+        ros::ServiceClient client,
+        marti_nav_msgs::PlanRoute::Request request);
+
+    void StartPlanning(const marti_nav_msgs::PlanRoute::Request& request);
     void Retry(const ros::TimerEvent& e);
 
+    static bool SameWaypoints(
+        const std::vector<geometry_msgs::Pose>& a,
+        const std::vector<geometry_msgs::Pose>& b);
+
     Ui::plan_route_config ui_;
     QWidget* config_widget_;
     mapviz::MapCanvas* map_canvas_;
@@ -117,6 +135,21 @@ namespace mapviz_plugins
     bool failed_service_;
     swri_route_util::RoutePtr route_preview_;
 
+    // Routes are planned on a worker thread, one request at a time.  While
+    // a request is in flight only the newest waypoints are kept, and the
+    // in-flight result is dropped if the waypoints changed after it was
+    // sent.  Replanning unchanged waypoints keeps the in-flight result.
+    std::string service_;
+    ros::ServiceClient client_;
+    QFutureWatcher<PlanResult> plan_watcher_;
+    bool has_queued_request_;
+    marti_nav_msgs::PlanRoute::Request queued_request_;
+    int request_generation_;
+    int sent_generation_;
+    std::string requested_service_;
+    bool requested_from_vehicle_;
+    std::vector<geometry_msgs::Pose> requested_waypoints_;
+
     std::vector<geometry_msgs::Pose> waypoints_;
 
     int selected_point_;
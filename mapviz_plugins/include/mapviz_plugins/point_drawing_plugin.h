@@ -31,9 +31,12 @@
 #define MAPVIZ_POINT_DRAW_H_
 
 // C++ standard libraries
+#include <deque>
 #include <string>
 #include <list>
+#include <vector>
 
+#include <mapviz/local_xy_converter.h>
 #include <mapviz/mapviz_plugin.h>
 #include <mapviz/map_canvas.h>
 
@@ -79,9 +82,7 @@ namespace mapviz_plugins
     };
 
     PointDrawingPlugin();
-    virtual ~PointDrawingPlugin()
-    {
-    }
+    virtual ~PointDrawingPlugin();
 
     void ClearHistory();
 
@@ -92,10 +93,9 @@ namespace mapviz_plugins
     virtual bool DrawLaps();
     virtual bool DrawLines();
     virtual void CollectLaps();
-    virtual bool DrawLapsArrows();
     virtual bool TransformPoint(StampedPoint& point);
     virtual void TransformPoint(StampedPoint& point, const swri_transform_util::Transform& transform);
-    virtual void UpdateColor(QColor base_color, int i);
+    virtual QColor LapColor(int i) const;
     virtual void DrawCovariance();
 
    protected Q_SLOTS:
@@ -107,6 +107,8 @@ namespace mapviz_plugins
     virtual void SetStaticArrowSizes(bool isChecked);
     virtual void SetArrowSize(int arrowSize);
     virtual void PositionToleranceChanged(double value);
+    virtual void PointIntervalChanged(double value);
+    virtual void SetInterpolatePose(bool checked);
     virtual void LapToggled(bool checked);
     virtual void CovariancedToggled(bool checked);
     virtual void ShowAllCovariancesToggled(bool checked);
@@ -117,8 +119,23 @@ namespace mapviz_plugins
 
    protected:
     void pushPoint(StampedPoint point);
+
+    /**
+     * Adds a point given in WGS84.  It is converted to the LocalXY frame
+     * with the shared converter, or held back until the LocalXY origin is
+     * known.  The history is reprojected whenever the origin changes.
+     */
+    void pushWgs84Point(StampedPoint point, double latitude, double longitude);
+    bool localXyInitialized() const;
     double bufferSize() const;
     double positionTolerance() const;
+    DrawStyle drawStyle() const;
+    QColor color() const;
+    int arrowSize() const;
+    bool staticArrowSizes() const;
+    double pointInterval() const;
+    bool interpolatePose() const;
+    StampedPoint CurrentPoint() const;
     const std::deque<StampedPoint>& points() const;
     bool single_frame_;
 
@@ -127,8 +144,13 @@ namespace mapviz_plugins
     int arrow_size_;
     DrawStyle draw_style_;
     StampedPoint cur_point_;
+    StampedPoint prev_point_;
+    ros::WallTime cur_received_;
+    ros::WallTime prev_received_;
     std::deque<StampedPoint> points_;
     double position_tolerance_;
+    double point_interval_;
+    bool interpolate_pose_;
     int buffer_size_;
     bool covariance_checked_;
     bool show_all_covariances_checked_;
@@ -141,9 +163,48 @@ namespace mapviz_plugins
     bool use_latest_transforms_;
 
    private:
-    std::vector<std::deque<StampedPoint> > laps_;
+    void ResetTransformedPoints(bool reset_laps);
+    void ClearLaps();
+    void UpdateLapBuffer();
+    void AddLapVertex(const tf::Point& point, const QColor& color);
+
+    // Completed laps are stored back to back in a single immutable
+    // trajectory; lap i spans [lap_ends_[i-1], lap_ends_[i]).
+    std::vector<StampedPoint> lap_points_;
+    std::vector<size_t> lap_ends_;
+    bool laps_transformed_;
     bool got_begin_;
     tf::Point begin_;
+
+    // Latest transform the laps were transformed with when all points are
+    // in a single frame; the laps are only retransformed when it changes.
+    tf::Vector3 lap_origin_;
+    tf::Quaternion lap_orientation_;
+
+    // Vertex and per-vertex color buffers holding the geometry of every
+    // completed lap, so that all laps are drawn with a single call.
+    bool lap_buffer_dirty_;
+    std::vector<float> lap_vertices_;
+    std::vector<uint8_t> lap_colors_;
+    GLuint lap_vertex_vbo_;
+    GLuint lap_color_vbo_;
+    GLsizei lap_vertex_count_;
+
+    struct Wgs84Point
+    {
+      StampedPoint point;
+      double latitude;
+      double longitude;
+    };
+
+    bool UpdateLocalXy();
+    void ReprojectPoints(int origin);
+
+    // Points received before the LocalXY origin was initialized; they are
+    // converted together as soon as it is.
+    std::deque<Wgs84Point> pending_wgs84_;
+    mapviz::LocalXyConverterPtr local_xy_;
+    int local_xy_origin_;
   };
 }
 
@@ -31,6 +31,10 @@
 #ifndef MAPVIZ_PLUGINS_POSE_ARRAY_PLUGIN_H_
 #define MAPVIZ_PLUGINS_POSE_ARRAY_PLUGIN_H_
 
+// C++ standard libraries
+#include <string>
+#include <vector>
+
 // Include mapviz_plugin.h first to ensure GL deps are included in the right order
 #include <mapviz/mapviz_plugin.h>
 #include <mapviz/map_canvas.h>
@@ -70,6 +74,8 @@ namespace mapviz_plugins
 
     void Draw(double x, double y, double scale);
 
+    void Transform();
+
     void LoadConfig(const YAML::Node& node, const std::string& path);
     void SaveConfig(YAML::Emitter& emitter, const std::string& path);
 
@@ -85,6 +91,14 @@ namespace mapviz_plugins
     void TopicEdited();
 
    private:
+    struct PoseInstance
+    {
+      double x;
+      double y;
+      double yaw;
+      bool valid;
+    };
+
     Ui::pose_array_config ui_;
     QWidget* config_widget_;
 
@@ -93,6 +107,34 @@ namespace mapviz_plugins
     ros::Subscriber pose_sub_;
     bool has_message_;
 
+    // Poses of the latest message in its source frame, relative to origin_
+    std::vector<PoseInstance> poses_;
+    tf::Point origin_;
+    ros::Time stamp_;
+
+    swri_transform_util::Transform transform_;
+    std::string transform_target_;
+    bool transformed_;
+
+    // Arrow or point geometry for every pose, built in the source frame and
+    // placed in the target frame with a single model matrix when drawn.
+    // Transforms from /wgs84 only have an origin, so for those the geometry
+    // is built in the target frame instead, relative to geometry_origin_,
+    // and rebuilt whenever the probes move.
+    bool geometry_dirty_;
+    bool geometry_transformed_;
+    tf::Point geometry_origin_;
+    std::vector<tf::Vector3> probes_;
+    DrawStyle geometry_style_;
+    int geometry_arrow_size_;
+    bool geometry_static_arrow_sizes_;
+    double geometry_scale_;
+    std::vector<float> vertices_;
+    GLuint vertex_vbo_;
+    GLsizei vertex_count_;
+
+    void UpdateGeometry(double scale, bool transform_points);
+
     void PoseArrayCallback(const geometry_msgs::PoseArrayConstPtr& msg);
   };
 }
@@ -45,6 +45,7 @@
 #include <tf/transform_datatypes.h>
 
 #include <mapviz/map_canvas.h>
+#include <mapviz_plugins/texture_cache.h>
 
 // QT autogenerated files
 #include "ui_robot_image_config.h"
@@ -101,24 +102,12 @@ namespace mapviz_plugins
     double image_ratio_;
 
     std::string filename_;
-    QImage      image_;
-    int dimension_;
-    int texture_id_;
-    bool texture_loaded_;
+    std::string image_path_;  // Resolved filename, empty if it can't be loaded
+    TextureCache::TexturePtr texture_;
 
     bool transformed_;
+    swri_transform_util::Transform transform_;
 
-    tf::Point top_left_;
-    tf::Point top_right_;
-    tf::Point bottom_left_;
-    tf::Point bottom_right_;
-
-    tf::Point top_left_transformed_;
-    tf::Point top_right_transformed_;
-    tf::Point bottom_left_transformed_;
-    tf::Point bottom_right_transformed_;
-
-    void UpdateShape();
     void LoadImage();
   };
 }
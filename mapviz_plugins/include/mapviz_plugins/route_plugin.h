@@ -47,7 +47,9 @@
 #include <tf/transform_datatypes.h>
 #include <marti_nav_msgs/RoutePosition.h>
 #include <mapviz/map_canvas.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
 #include <swri_route_util/route.h>
+#include <swri_transform_util/transform.h>
 
 // QT autogenerated files
 #include "ui_route_config.h"
@@ -80,7 +82,7 @@ namespace mapviz_plugins
     void LoadConfig(const YAML::Node& node, const std::string& path);
     void SaveConfig(YAML::Emitter& emitter, const std::string& path);
     void DrawStopWaypoint(double x, double y);
-    void DrawRoute(const swri_route_util::Route &route);
+    void DrawRoute(double x, double y, double scale);
     void DrawRoutePoint(const swri_route_util::RoutePoint &point);
 
     QWidget* GetConfigWidget(QWidget* parent);
@@ -112,9 +114,28 @@ namespace mapviz_plugins
 
     swri_route_util::Route src_route_;
     marti_nav_msgs::RoutePositionConstPtr src_route_position_;
-    
+
+    // The route transformed into the target frame, which is only rebuilt
+    // when the route, the target frame or the transform changes.
+    bool route_dirty_;
+    swri_route_util::Route route_;
+    std::string route_frame_;
+    std::vector<double> distances_;
+    std::vector<tf::Vector3> probes_;
+    PathVertexBuffer route_buffer_;
+
+    // Where the route position was last found, so that the next lookup
+    // usually only has to check a few points and segments.
+    size_t position_index_;
+    size_t segment_index_;
+
     void RouteCallback(const marti_nav_msgs::RouteConstPtr &msg);
     void PositionCallback(const marti_nav_msgs::RoutePositionConstPtr &msg);
+
+    bool UpdateRoute(const swri_transform_util::Transform& transform);
+    bool InterpolatePosition(
+        swri_route_util::RoutePoint& point,
+        const marti_nav_msgs::RoutePosition& position);
   };
 }
 
@@ -0,0 +1,82 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_PLUGINS_SHARED_MESSAGE_CACHE_H_
+#define MAPVIZ_PLUGINS_SHARED_MESSAGE_CACHE_H_
+
+#include <typeindex>
+#include <typeinfo>
+
+#include <boost/shared_ptr.hpp>
+
+#include <topic_tools/shape_shifter.h>
+
+namespace mapviz_plugins
+{
+  /**
+   * Caches the typed messages instantiated from ShapeShifter messages.
+   *
+   * roscpp hands every ShapeShifter subscriber on a topic the same message,
+   * but each display then deserializes its own copy with instantiate<M>().
+   * When several displays show the same topic, the first one to instantiate
+   * a message stores the result here and the others reuse it.  The cache
+   * only holds weak references; entries expire with the ShapeShifter they
+   * were created from or once no display holds the typed message.
+   */
+  class SharedMessageCache
+  {
+  public:
+    template <class M>
+    static boost::shared_ptr<const M> Instantiate(
+        const topic_tools::ShapeShifter::ConstPtr& msg)
+    {
+      boost::shared_ptr<const void> cached = Find(msg, typeid(M));
+      if (cached)
+      {
+        return boost::static_pointer_cast<const M>(cached);
+      }
+
+      boost::shared_ptr<const M> typed = msg->instantiate<M>();
+      Insert(msg, typeid(M), typed);
+      return typed;
+    }
+
+  private:
+    static boost::shared_ptr<const void> Find(
+        const topic_tools::ShapeShifter::ConstPtr& msg,
+        const std::type_index& type);
+
+    static void Insert(
+        const topic_tools::ShapeShifter::ConstPtr& msg,
+        const std::type_index& type,
+        const boost::shared_ptr<const void>& typed);
+  };
+}
+
+#endif  // MAPVIZ_PLUGINS_SHARED_MESSAGE_CACHE_H_
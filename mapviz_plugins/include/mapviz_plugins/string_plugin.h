@@ -84,7 +84,6 @@ namespace mapviz_plugins
     void Shutdown() {}
 
     void Draw(double x, double y, double scale);
-    void Paint(QPainter* painter, double x, double y, double scale);
 
     void Transform() {}
 
@@ -93,13 +92,15 @@ namespace mapviz_plugins
 
     QWidget* GetConfigWidget(QWidget* parent);
 
-    bool SupportsPainting()
+    bool SupportsHud()
     {
       return true;
     }
 
+    QRect HudRect();
+    void PaintHud(QPainter* painter, const QSize& size);
+
   protected:
-    void PaintText(QPainter* painter);
     void PrintError(const std::string& message);
     void PrintInfo(const std::string& message);
     void PrintWarning(const std::string& message);
@@ -126,7 +127,6 @@ namespace mapviz_plugins
 
     ros::Subscriber string_sub_;
     bool has_message_;
-    bool has_painted_;
 
     QColor color_;
     QFont font_;
@@ -0,0 +1,90 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_PLUGINS_TEXTURE_CACHE_H_
+#define MAPVIZ_PLUGINS_TEXTURE_CACHE_H_
+
+// C++ standard libraries
+#include <string>
+
+// Boost libraries
+#include <boost/shared_ptr.hpp>
+
+// QT libraries
+#include <QGLWidget>
+#include <QSize>
+
+namespace mapviz_plugins
+{
+  /**
+   * Shares the GL textures of image files between displays.
+   *
+   * Displays that load the same file (e.g. several robots drawn with the
+   * same icon) get the same texture, which is uploaded once with a full
+   * mipmap chain so that it stays smooth when zoomed out.  A texture is
+   * freed when the last display releases it; like the other GL resources
+   * of a plugin, that has to happen with the canvas context current.
+   */
+  class TextureCache
+  {
+  public:
+    struct Texture
+    {
+      GLuint id;
+      QSize size;  // Size of the original image, before the power-of-two stretch
+    };
+    typedef boost::shared_ptr<const Texture> TexturePtr;
+
+    /**
+     * Resolves a "$(find package)" prefix in a filename to the package path.
+     */
+    static std::string ResolvePath(const std::string& filename);
+
+    /**
+     * Returns the texture for an image file, loading it if no display holds
+     * it yet.  Returns an empty pointer if the image can't be loaded.  Must
+     * be called with the canvas context current.
+     */
+    static TexturePtr Get(const std::string& path);
+
+    /**
+     * Draws a unit square centered at the origin with the texture mapped
+     * onto it.  Texture coordinate (0, 0) is at (-0.5, -0.5).
+     */
+    static void DrawQuad(const Texture& texture);
+
+    /**
+     * Draws the texture onto a quad with the given corners, as x, y pairs
+     * in the order top left, top right, bottom right, bottom left.
+     */
+    static void DrawQuad(const Texture& texture, const GLdouble* corners);
+  };
+}
+
+#endif  // MAPVIZ_PLUGINS_TEXTURE_CACHE_H_
@@ -32,6 +32,7 @@
 
 // C++ standard libraries
 #include <list>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -40,11 +41,13 @@
 // QT libraries
 #include <QGLWidget>
 #include <QObject>
+#include <QTimer>
 #include <QWidget>
 
 // ROS libraries
 #include <ros/ros.h>
 #include <tf/transform_datatypes.h>
+#include <tf2_msgs/TFMessage.h>
 
 #include <mapviz/map_canvas.h>
 
@@ -82,14 +85,27 @@ namespace mapviz_plugins
    protected Q_SLOTS:
     void SelectFrame();
     void FrameEdited();
+    void TargetFrameEdited();
+    void Sample();
 
    private:
     Ui::tf_frame_config ui_;
     QWidget* config_widget_;
 
-    ros::Timer timer_;
+    ros::Subscriber tf_sub_;
+    ros::Subscriber tf_static_sub_;
 
-    void TimerCallback(const ros::TimerEvent& event);
+    // Child frames of every edge between the source and target frames.
+    std::set<std::string> chain_;
+    ros::WallTime chain_updated_;
+
+    ros::WallTime last_sample_;
+    ros::Time last_sample_stamp_;
+    QTimer sample_timer_;
+
+    void TfCallback(const tf2_msgs::TFMessageConstPtr& msg);
+    void UpdateChain();
+    bool ChainContains(const std::string& frame) const;
   };
 }
 
@@ -0,0 +1,95 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#ifndef MAPVIZ_PLUGINS_VERTEX_PICKER_H_
+#define MAPVIZ_PLUGINS_VERTEX_PICKER_H_
+
+// C++ standard libraries
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// QT libraries
+#include <QPointF>
+#include <QTransform>
+
+// ROS libraries
+#include <tf/transform_datatypes.h>
+
+namespace mapviz_plugins
+{
+  /**
+   * Finds the vertex closest to a point on the screen.
+   *
+   * The screen positions of the vertices are bucketed into a grid with
+   * cells as large as the pick radius, so a pick only has to look at the
+   * 3x3 cells around the cursor.  The grid is rebuilt lazily on the next
+   * pick after the vertices, the view transform or the radius change.
+   */
+  class VertexPicker
+  {
+  public:
+    VertexPicker();
+
+    /**
+     * Replaces the vertices; they should be in the canvas' fixed frame.
+     */
+    void SetVertices(const std::vector<tf::Vector3>& vertices);
+
+    void Clear();
+
+    /**
+     * Returns the index of the vertex closest to the given screen point that
+     * is less than radius pixels away, or -1 if there is none.
+     */
+    int Pick(const QTransform& view, const QPointF& point, double radius);
+
+  private:
+    void Build(const QTransform& view, double radius);
+
+    int64_t CellKey(int64_t cell_x, int64_t cell_y) const
+    {
+      return static_cast<int64_t>(
+          (static_cast<uint64_t>(cell_x) << 32) ^
+          (static_cast<uint64_t>(cell_y) & 0xFFFFFFFFu));
+    }
+
+    std::vector<QPointF> vertices_;
+    std::vector<QPointF> screen_;
+
+    // (cell key, vertex index) pairs, sorted by key.
+    std::vector<std::pair<int64_t, int> > cells_;
+
+    bool valid_;
+    QTransform view_;
+    double cell_size_;
+  };
+}
+
+#endif  // MAPVIZ_PLUGINS_VERTEX_PICKER_H_
@@ -28,10 +28,11 @@
 // *****************************************************************************
 
 #include <mapviz_plugins/attitude_indicator_plugin.h>
-#include <GL/glut.h>
+#include <mapviz_plugins/shared_message_cache.h>
 
 // C++ standard libraries
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -39,6 +40,9 @@
 #include <QDebug>
 #include <QDialog>
 #include <QGLWidget>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPolygonF>
 
 // ROS libraries
 #include <ros/master.h>
@@ -74,6 +78,9 @@ namespace mapviz_plugins
     p3.setColor(QPalette::Text, Qt::red);
     ui_.status->setPalette(p3);
 
+    buildBackground();
+    buildPanel();
+
     placer_.setRect(QRect(0, 0, 100, 100));
     QObject::connect(this, SIGNAL(VisibleChanged(bool)),
                      &placer_, SLOT(setVisible(bool)));
@@ -123,15 +130,15 @@ namespace mapviz_plugins
   {
     if (IS_INSTANCE(msg, nav_msgs::Odometry))
     {
-      AttitudeCallbackOdom(msg->instantiate<nav_msgs::Odometry>());
+      AttitudeCallbackOdom(SharedMessageCache::Instantiate<nav_msgs::Odometry>(msg));
     }
     else if (IS_INSTANCE(msg, sensor_msgs::Imu))
     {
-      AttitudeCallbackImu(msg->instantiate<sensor_msgs::Imu>());
+      AttitudeCallbackImu(SharedMessageCache::Instantiate<sensor_msgs::Imu>(msg));
     }
     else if (IS_INSTANCE(msg, geometry_msgs::Pose))
     {
-      AttitudeCallbackPose(msg->instantiate<geometry_msgs::Pose>());
+      AttitudeCallbackPose(SharedMessageCache::Instantiate<geometry_msgs::Pose>(msg));
     }
     else
     {
@@ -168,7 +175,7 @@ namespace mapviz_plugins
     pitch_ = pitch_ * (180.0 / M_PI);
     yaw_ = yaw_ * (180.0 / M_PI);
 
-    canvas_->update();
+    UpdateHud();
   }
 
   void AttitudeIndicatorPlugin::PrintError(const std::string& message)
@@ -197,7 +204,6 @@ namespace mapviz_plugins
     initialized_ = true;
     canvas_ = canvas;
     placer_.setContainer(canvas_);
-    startTimer(50);
     return true;
   }
 
@@ -206,145 +212,132 @@ namespace mapviz_plugins
     placer_.setContainer(NULL);
   }
 
-  void AttitudeIndicatorPlugin::timerEvent(QTimerEvent*)
-  {
-    canvas_->update();
-  }
-
-  void AttitudeIndicatorPlugin::drawBall()
+  QRect AttitudeIndicatorPlugin::HudRect()
   {
-    GLdouble eqn[4] = {0.0, 0.0, 1.0, 0.0};
-    GLdouble eqn2[4] = {0.0, 0.0, -1.0, 0.0};
-    GLdouble eqn4[4] = {0.0, 0.0, 1.0, 0.05};
-    GLdouble eqn3[4] = {0.0, 0.0, -1.0, 0.05};
-
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-
-    glPushMatrix();
-
-    glColor3f(0.392156863f, 0.584313725f, 0.929411765f);
-    glRotated(90.0 + pitch_, 1.0, 0.0, 0.0);
-
-    glRotated(roll_, 0.0, 1.0, 0.0);
-    glRotated(yaw_, 0.0, 0.0, 1.0);
-    glClipPlane(GL_CLIP_PLANE1, eqn2);
-    glEnable(GL_CLIP_PLANE1);
-    glutSolidSphere(.8, 20, 16);
-    glDisable(GL_CLIP_PLANE1);
-    glPopMatrix();
-
-    glPushMatrix();
-
-    glLineWidth(2);
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRotated(90.0 + pitch_, 1.0, 0.0, 0.0);
-    glRotated(roll_, 0.0, 1.0, 0.0);
-    glRotated(yaw_, 0.0, 0.0, 1.0);
-    glClipPlane(GL_CLIP_PLANE3, eqn4);
-    glClipPlane(GL_CLIP_PLANE2, eqn3);
-    glEnable(GL_CLIP_PLANE2);
-    glEnable(GL_CLIP_PLANE3);
-    glutWireSphere(.801, 10, 16);
-    glDisable(GL_CLIP_PLANE2);
-    glDisable(GL_CLIP_PLANE3);
-    glPopMatrix();
-
-    glPushMatrix();
-    glColor3f(0.62745098f, 0.321568627f, 0.176470588f);
-    glRotated(90.0 + pitch_, 1.0, 0.0, 0.0);//x
-    glRotated(roll_, 0.0, 1.0, 0.0);//y
-    glRotated(yaw_, 0.0, 0.0, 1.0);//z
-    glClipPlane(GL_CLIP_PLANE0, eqn);
-    glEnable(GL_CLIP_PLANE0);
-    glutSolidSphere(.8, 20, 16);
-    glDisable(GL_CLIP_PLANE0);
-    glPopMatrix();
-    glDisable(GL_DEPTH_TEST);
+    return placer_.rect();
   }
 
   void AttitudeIndicatorPlugin::Draw(double x, double y, double scale)
   {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    glOrtho(0, canvas_->width(), canvas_->height(), 0, -1.0f, 1.0f);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-    // Setup coordinate system so that we have a [-1,1]x[1,1] cube on
-    // the screen.
-    QRect rect = placer_.rect();
-    double s_x = rect.width() / 2.0;
-    double s_y = -rect.height() / 2.0;
-    double t_x = rect.right() - s_x;
-    double t_y = rect.top() - s_y;
-
-    double m[16] = {
-        s_x, 0, 0, 0,
-        0, s_y, 0, 0,
-        0, 0, 1.0, 0,
-        t_x, t_y, 0, 1.0};
-    glMultMatrixd(m);
-
-    // Placed in a separate function so that we don't forget to pop the
-    // GL state back.
-
-    drawBackground();
-    drawBall();
-
-    drawPanel();
-
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
-    glPopAttrib();
+    // The indicator is drawn as a HUD overlay; see PaintHud().
     PrintInfo("OK!");
   }
 
-  void AttitudeIndicatorPlugin::drawBackground()
+  void AttitudeIndicatorPlugin::PaintHud(QPainter* painter, const QSize& size)
   {
-    glBegin(GL_TRIANGLES);
-    glColor4f(0.0f, 0.0f, 0.0f, 1.0f);
+    // Map the [-1,1]x[-1,1] unit square onto the overlay with y pointing up.
+    painter->translate(size.width() / 2.0, size.height() / 2.0);
+    painter->scale(size.width() / 2.0, -size.height() / 2.0);
 
-    glVertex2d(-1.0, -1.0);
-    glVertex2d(-1.0, 1.0);
-    glVertex2d(1.0, 1.0);
+    painter->drawPicture(0, 0, background_);
+    drawBall(painter);
+    painter->drawPicture(0, 0, panel_);
+  }
 
-    glVertex2d(-1.0, -1.0);
-    glVertex2d(1.0, 1.0);
-    glVertex2d(1.0, -1.0);
+  void AttitudeIndicatorPlugin::drawBall(QPainter* painter)
+  {
+    const double radius = 0.8;
+    const double band = 0.05;
+    const int segments = 32;
+    const int heading_ticks = 10;
+    const QColor sky(100, 149, 237);
+    const QColor ground(160, 82, 45);
+
+    // The ball is a sphere seen from the front (+z) in orthographic
+    // projection, rotated the same way as the original GL rendering: its
+    // axis lies along the view axis at zero pitch, then it's rotated about
+    // x by the pitch, about y by the roll and about its axis by the yaw.
+    const double to_rad = M_PI / 180.0;
+    tf::Matrix3x3 rotation =
+        tf::Matrix3x3(tf::Quaternion(tf::Vector3(1, 0, 0), (90.0 + pitch_) * to_rad)) *
+        tf::Matrix3x3(tf::Quaternion(tf::Vector3(0, 1, 0), roll_ * to_rad)) *
+        tf::Matrix3x3(tf::Quaternion(tf::Vector3(0, 0, 1), yaw_ * to_rad));
+
+    // The ground is the hemisphere on the positive side of the ball's axis.
+    // Rotated so that the axis points straight down on the screen, the
+    // visible half of the horizon is half of an ellipse from (r, 0) to
+    // (-r, 0) through (0, r * axis.z).
+    tf::Vector3 axis = rotation * tf::Vector3(0, 0, 1);
+    double angle = std::atan2(axis.y(), axis.x()) / to_rad + 90.0;
+    double peak = radius * axis.z();
+
+    QPolygonF ground_area;
+    for (int i = 0; i <= segments; i++)
+    {
+      double theta = M_PI * i / segments;
+      ground_area << QPointF(-radius * std::cos(theta), -radius * std::sin(theta));
+    }
 
-    glEnd();
+    QPolygonF horizon;
+    for (int i = 0; i <= segments; i++)
+    {
+      double theta = M_PI * i / segments;
+      horizon << QPointF(radius * std::cos(theta), peak * std::sin(theta));
+    }
+    ground_area << horizon;
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(sky);
+    painter->drawEllipse(QPointF(0.0, 0.0), radius, radius);
+
+    QPen pen(Qt::white, 2);
+    pen.setCosmetic(true);
+
+    painter->save();
+    painter->rotate(angle);
+    painter->setBrush(ground);
+    painter->drawPolygon(ground_area);
+    painter->setPen(pen);
+    painter->drawPolyline(horizon);
+    painter->restore();
+
+    // Heading is shown by ticks across the horizon that turn with the yaw,
+    // like the meridians of the old wireframe band.
+    painter->setPen(pen);
+    double rho = std::sqrt(radius * radius - band * band);
+    for (int i = 0; i < heading_ticks; i++)
+    {
+      double longitude = 2.0 * M_PI * i / heading_ticks;
+      double x = rho * std::cos(longitude);
+      double y = rho * std::sin(longitude);
+      tf::Vector3 lower = rotation * tf::Vector3(x, y, -band);
+      tf::Vector3 upper = rotation * tf::Vector3(x, y, band);
+      if (lower.z() + upper.z() > 0.0)
+      {
+        painter->drawLine(QPointF(lower.x(), lower.y()), QPointF(upper.x(), upper.y()));
+      }
+    }
   }
 
-  void AttitudeIndicatorPlugin::drawPanel()
+  void AttitudeIndicatorPlugin::buildBackground()
   {
-    glLineWidth(2);
+    QPainter painter(&background_);
+    painter.fillRect(QRectF(-1.0, -1.0, 2.0, 2.0), Qt::black);
+  }
 
-    glBegin(GL_LINE_STRIP);
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+  void AttitudeIndicatorPlugin::buildPanel()
+  {
+    QPainter painter(&panel_);
+    QPen pen(Qt::white, 2);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
 
-    glVertex2d(-0.9, 0.0);
-    glVertex2d(-0.2, 0.0);
+    QPainterPath wings;
+    wings.moveTo(-0.9, 0.0);
+    wings.lineTo(-0.2, 0.0);
 
     int divisions = 20;
     for (int i = 1; i < divisions; i++)
     {
-      glVertex2d(-0.2 * std::cos(M_PI * i / divisions),
-                 -0.2 * std::sin(M_PI * i / divisions));
+      wings.lineTo(-0.2 * std::cos(M_PI * i / divisions),
+                   -0.2 * std::sin(M_PI * i / divisions));
     }
 
-    glVertex2f(0.2, 0.0);
-    glVertex2f(0.9, 0.0);
-    glEnd();
+    wings.lineTo(0.2, 0.0);
+    wings.lineTo(0.9, 0.0);
+    painter.drawPath(wings);
 
-    glBegin(GL_LINES);
-    glVertex2f(0.0, -0.2f);
-    glVertex2f(0.0, -0.9f);
-    glEnd();
+    painter.drawLine(QPointF(0.0, -0.2), QPointF(0.0, -0.9));
   }
 
   void AttitudeIndicatorPlugin::LoadConfig(const YAML::Node& node, const std::string& path)
@@ -30,6 +30,7 @@
 #include <mapviz_plugins/draw_polygon_plugin.h>
 
 // C++ standard libraries
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -57,9 +58,13 @@ namespace stu = swri_transform_util;
 
 namespace mapviz_plugins
 {
+  // Maximum distance, in pixels, between a click and the vertex it selects.
+  static const double PICK_RADIUS = 15.0;
+
   DrawPolygonPlugin::DrawPolygonPlugin() :
     config_widget_(new QWidget()),
     map_canvas_(NULL),
+    vertices_dirty_(true),
     selected_point_(-1),
     is_mouse_down_(false),
     max_ms_(Q_INT64_C(500)),
@@ -92,6 +97,9 @@ namespace mapviz_plugins
     if (map_canvas_)
     {
       map_canvas_->removeEventFilter(this);
+
+      // Allow the vertex buffer to release its GL resources
+      map_canvas_->makeCurrent();
     }
   }
 
@@ -112,6 +120,7 @@ namespace mapviz_plugins
 
     ROS_INFO("Setting target frame to to %s", source_frame_.c_str());
 
+    vertices_dirty_ = true;
     initialized_ = true;
   }
 
@@ -143,7 +152,79 @@ namespace mapviz_plugins
   void DrawPolygonPlugin::Clear()
   {
     vertices_.clear();
-    transformed_vertices_.clear();
+    vertices_dirty_ = true;
+  }
+
+  bool DrawPolygonPlugin::UpdateTransformedVertices()
+  {
+    stu::Transform transform;
+    std::string frame = ui_.frame->text().toStdString();
+    if (!tf_manager_->GetTransform(target_frame_, frame, transform))
+    {
+      return false;
+    }
+
+    // Transforms from WGS84 aren't rigid, so changes are detected by
+    // transforming a few of the vertices rather than comparing transforms.
+    std::vector<tf::Vector3> probes;
+    probes.reserve(probe_points_.size());
+    for (const auto& point: probe_points_)
+    {
+      probes.push_back(transform * point);
+    }
+
+    if (vertices_dirty_ || probes != probes_)
+    {
+      transformed_vertices_.resize(vertices_.size());
+      for (size_t i = 0; i < vertices_.size(); i++)
+      {
+        transformed_vertices_[i] = transform * vertices_[i];
+      }
+
+      probe_points_.clear();
+      probes_.clear();
+      if (!vertices_.empty())
+      {
+        probe_points_.push_back(vertices_.front());
+        probe_points_.push_back(vertices_[vertices_.size() / 2]);
+        probe_points_.push_back(vertices_.back());
+        for (const auto& point: probe_points_)
+        {
+          probes_.push_back(transform * point);
+        }
+      }
+
+      vertex_buffer_.SetVertices(transformed_vertices_);
+      picker_.SetVertices(transformed_vertices_);
+      vertices_dirty_ = false;
+    }
+
+    transform_ = transform;
+    return true;
+  }
+
+  void DrawPolygonPlugin::MoveVertex(int index, const QPointF& point)
+  {
+    stu::Transform transform;
+    std::string frame = ui_.frame->text().toStdString();
+    if (!tf_manager_->GetTransform(frame, target_frame_, transform))
+    {
+      return;
+    }
+
+    QPointF transformed = map_canvas_->MapGlCoordToFixedFrame(point);
+    tf::Vector3 position(transformed.x(), transformed.y(), 0.0);
+    position = transform * position;
+    vertices_[index].setX(position.x());
+    vertices_[index].setY(position.y());
+
+    // Only the moved vertex needs to be transformed again.
+    if (!vertices_dirty_ && static_cast<size_t>(index) < transformed_vertices_.size())
+    {
+      transformed_vertices_[index] = transform_ * vertices_[index];
+      vertex_buffer_.SetVertices(transformed_vertices_);
+      picker_.SetVertices(transformed_vertices_);
+    }
   }
 
   void DrawPolygonPlugin::PrintError(const std::string& message)
@@ -170,6 +251,7 @@ namespace mapviz_plugins
 
   bool DrawPolygonPlugin::Initialize(QGLWidget* canvas)
   {
+    canvas_ = canvas;
     map_canvas_ = static_cast<mapviz::MapCanvas*>(canvas);
     map_canvas_->installEventFilter(this);
 
@@ -201,38 +283,21 @@ namespace mapviz_plugins
     }
     
     selected_point_ = -1;
-    int closest_point = 0;
-    double closest_distance = std::numeric_limits<double>::max();
+    int closest_point = -1;
 
 #if QT_VERSION >= 0x050000
     QPointF point = event->localPos();
 #else
     QPointF point = event->posF();
 #endif
-    stu::Transform transform;
-    std::string frame = ui_.frame->text().toStdString();
-    if (tf_manager_->GetTransform(target_frame_, frame, transform))
+    if (UpdateTransformedVertices())
     {
-      for (size_t i = 0; i < vertices_.size(); i++)
-      {
-        tf::Vector3 vertex = vertices_[i];
-        vertex = transform * vertex;
-
-        QPointF transformed = map_canvas_->FixedFrameToMapGlCoord(QPointF(vertex.x(), vertex.y()));
-
-        double distance = QLineF(transformed, point).length();
-
-        if (distance < closest_distance)
-        {
-          closest_distance = distance;
-          closest_point = static_cast<int>(i);
-        }
-      }
+      closest_point = picker_.Pick(map_canvas_->ViewTransform(), point, PICK_RADIUS);
     }
 
     if (event->button() == Qt::LeftButton)
     {
-      if (closest_distance < 15)
+      if (closest_point >= 0)
       {
         selected_point_ = closest_point;
         return true;
@@ -251,10 +316,10 @@ namespace mapviz_plugins
     }
     else if (event->button() == Qt::RightButton)
     {
-      if (closest_distance < 15)
+      if (closest_point >= 0)
       {
         vertices_.erase(vertices_.begin() + closest_point);
-        transformed_vertices_.resize(vertices_.size());
+        vertices_dirty_ = true;
         return true;
       }
     }
@@ -272,15 +337,7 @@ namespace mapviz_plugins
 #else
       QPointF point = event->posF();
 #endif
-      stu::Transform transform;
-      if (tf_manager_->GetTransform(frame, target_frame_, transform))
-      {
-        QPointF transformed = map_canvas_->MapGlCoordToFixedFrame(point);
-        tf::Vector3 position(transformed.x(), transformed.y(), 0.0);
-        position = transform * position;
-        vertices_[selected_point_].setX(position.x());
-        vertices_[selected_point_].setY(position.y());
-      }
+      MoveVertex(selected_point_, point);
 
       selected_point_ = -1;
       return true;
@@ -316,7 +373,7 @@ namespace mapviz_plugins
         {
           position = transform * position;
           vertices_.push_back(position);
-          transformed_vertices_.resize(vertices_.size());
+          vertices_dirty_ = true;
           ROS_INFO("Adding vertex at %lf, %lf %s", position.x(), position.y(), frame.c_str());
         }
       }
@@ -335,16 +392,7 @@ namespace mapviz_plugins
 #else
       QPointF point = event->posF();
 #endif
-      stu::Transform transform;
-      std::string frame = ui_.frame->text().toStdString();
-      if (tf_manager_->GetTransform(frame, target_frame_, transform))
-      {
-        QPointF transformed = map_canvas_->MapGlCoordToFixedFrame(point);
-        tf::Vector3 position(transformed.x(), transformed.y(), 0.0);
-        position = transform * position;
-        vertices_[selected_point_].setY(position.y());
-        vertices_[selected_point_].setX(position.x());
-      }
+      MoveVertex(selected_point_, point);
 
       return true;
     }
@@ -353,30 +401,19 @@ namespace mapviz_plugins
 
   void DrawPolygonPlugin::Draw(double x, double y, double scale)
   {
-    stu::Transform transform;
-    std::string frame = ui_.frame->text().toStdString();
-    if (!tf_manager_->GetTransform(target_frame_, frame, transform))
+    if (!UpdateTransformedVertices())
     {
       return;
     }
 
-    // Transform polygon
-    for (size_t i = 0; i < vertices_.size(); i++)
-    {
-      transformed_vertices_[i] = transform * vertices_[i];
-    }
+    const double radius = 0.5 * scale * std::sqrt(
+        static_cast<double>(canvas_->width() * canvas_->width() +
+                            canvas_->height() * canvas_->height()));
 
     glLineWidth(1);
     const QColor color = ui_.color->color();
     glColor4d(color.redF(), color.greenF(), color.blueF(), 1.0);
-    glBegin(GL_LINE_STRIP);
-
-    for (const auto& vertex: transformed_vertices_)
-    {
-      glVertex2d(vertex.x(), vertex.y());
-    }
-
-    glEnd();
+    vertex_buffer_.Draw(GL_LINE_STRIP, x, y, radius);
 
     glBegin(GL_LINES);
 
@@ -392,15 +429,7 @@ namespace mapviz_plugins
 
     // Draw vertices
     glPointSize(9);
-    glBegin(GL_POINTS);
-
-    for (const auto& vertex: transformed_vertices_)
-    {
-      glVertex2d(vertex.x(), vertex.y());
-    }
-    glEnd();
-
-
+    vertex_buffer_.Draw(GL_POINTS, x, y, radius);
 
     PrintInfo("OK");
   }
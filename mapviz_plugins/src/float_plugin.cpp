@@ -30,6 +30,8 @@
 
 #include <mapviz_plugins/float_plugin.h>
 
+#include <cmath>
+
 #include <pluginlib/class_list_macros.h>
 #include <mapviz/select_topic_dialog.h>
 
@@ -61,7 +63,6 @@ namespace mapviz_plugins
     offset_x_(0),
     offset_y_(0),
     has_message_(false),
-    has_painted_(false),
     color_(Qt::black)
   {
     ui_.setupUi(config_widget_);
@@ -104,36 +105,9 @@ namespace mapviz_plugins
 
   void FloatPlugin::Draw(double x, double y, double scale)
   {
-    // This plugin doesn't do any  OpenGL drawing.
-  }
-
-  void FloatPlugin::Paint(QPainter* painter, double x, double y, double scale)
-  {
+    // The text is drawn as a HUD overlay; see PaintHud().
     if (has_message_)
     {
-      painter->save();
-      painter->resetTransform();
-      painter->setFont(font_);
-
-      if (!has_painted_)
-      {
-        // After the first time we get a new message, we do not know how wide it's
-        // going to be when rendered, so we can't accurately calculate the top left
-        // coordinate if it's offset from the right or bottom borders.
-        // The easiest workaround I've found for this is to draw it once using
-        // a completely transparent pen, which will cause the QStaticText class to
-        // know how wide it is; then we can recalculate the offsets and draw it
-        // again with a visible pen.
-        QPen invisPen(QBrush(Qt::transparent), 1);
-        painter->setPen(invisPen);
-        PaintText(painter);
-        has_painted_ = true;
-      }
-      QPen pen(QBrush(color_), 1);
-      painter->setPen(pen);
-      PaintText(painter);
-
-      painter->restore();
       PrintInfo("OK");
     }
     else
@@ -142,8 +116,13 @@ namespace mapviz_plugins
     }
   }
 
-  void FloatPlugin::PaintText(QPainter* painter)
+  QRect FloatPlugin::HudRect()
   {
+    if (!has_message_)
+    {
+      return QRect();
+    }
+
     // Calculate the correct offsets and dimensions
     int x_offset = offset_x_;
     int y_offset = offset_y_;
@@ -153,6 +132,9 @@ namespace mapviz_plugins
       y_offset = static_cast<int>((float)(offset_y_ * canvas_->height()) / 100.0);
     }
 
+    QSize size(static_cast<int>(std::ceil(message_.size().width())) + 1,
+               static_cast<int>(std::ceil(message_.size().height())) + 1);
+
     int right = static_cast<int>((float)canvas_->width() - message_.size().width()) - x_offset;
     int bottom = static_cast<int>((float)canvas_->height() - message_.size().height()) - y_offset;
     int yCenter = static_cast<int>((float)canvas_->height() / 2.0 - message_.size().height()/2.0);
@@ -199,7 +181,14 @@ namespace mapviz_plugins
         ulPoint.setY(bottom);
         break;
     }
-    painter->drawStaticText(ulPoint, message_);
+    return QRect(ulPoint, size);
+  }
+
+  void FloatPlugin::PaintHud(QPainter* painter, const QSize& size)
+  {
+    painter->setFont(font_);
+    painter->setPen(QPen(QBrush(color_), 1));
+    painter->drawStaticText(QPoint(0, 0), message_);
   }
 
   void FloatPlugin::LoadConfig(const YAML::Node& node, const std::string& path)
@@ -213,6 +202,8 @@ namespace mapviz_plugins
     if (node[FONT_KEY])
     {
       font_.fromString(QString(node[FONT_KEY].as<std::string>().c_str()));
+      message_.prepare(QTransform(), font_);
+      UpdateHud();
       ui_.font_button->setFont(font_);
       ui_.font_button->setText(font_.family());
     }
@@ -221,6 +212,7 @@ namespace mapviz_plugins
     {
       color_ = QColor(node[COLOR_KEY].as<std::string>().c_str());
       ui_.color->setColor(QColor(color_.name().toStdString().c_str()));
+      UpdateHud();
     }
 
     if (node[ANCHOR_KEY])
@@ -292,6 +284,7 @@ namespace mapviz_plugins
   void FloatPlugin::SelectColor()
   {
     color_ = ui_.color->color();
+    UpdateHud();
   }
 
   void FloatPlugin::PostfixEdited()
@@ -307,6 +300,7 @@ namespace mapviz_plugins
     {
       font_ = font;
       message_.prepare(QTransform(), font_);
+      UpdateHud();
       ui_.font_button->setFont(font_);
       ui_.font_button->setText(font_.family());
     }
@@ -338,12 +332,14 @@ namespace mapviz_plugins
       has_message_ = false;
       PrintWarning("No messages received.");
 
-      float_sub_.shutdown();
+      UnsubscribeLazily(float_sub_);
 
       topic_ = topic;
       if (!topic.empty())
       {
-        float_sub_ = node_.subscribe<topic_tools::ShapeShifter>(topic_, 1, &FloatPlugin::floatCallback, this);
+        SubscribeLazily(float_sub_, [this]() {
+          return node_.subscribe<topic_tools::ShapeShifter>(topic_, 1, &FloatPlugin::floatCallback, this);
+        });
 
         ROS_INFO("Subscribing to %s", topic_.c_str());
       }
@@ -449,8 +445,8 @@ namespace mapviz_plugins
     message_.prepare(QTransform(), font_);
 
     has_message_ = true;
-    has_painted_ = false;
     initialized_ = true;
+    UpdateHud();
   }
 
   std::string FloatPlugin::AnchorToString(FloatPlugin::Anchor anchor)
@@ -123,10 +123,6 @@ namespace mapviz_plugins
 
   void GpsPlugin::GPSFixCallback(const gps_common::GPSFixConstPtr& gps)
   {  
-    if (!tf_manager_->LocalXyUtil()->Initialized())
-    {
-      return;
-    }
     if (!has_message_)
     {
       initialized_ = true;
@@ -135,12 +131,7 @@ namespace mapviz_plugins
 
     StampedPoint stamped_point;
     stamped_point.stamp = gps->header.stamp;
-    stamped_point.source_frame = tf_manager_->LocalXyUtil()->Frame();
-    double x;
-    double y;
-    tf_manager_->LocalXyUtil()->ToLocalXy(gps->latitude, gps->longitude, x, y);
-
-    stamped_point.point = tf::Point(x, y, gps->altitude);
+    stamped_point.point = tf::Point(0.0, 0.0, gps->altitude);
 
     // The GPS "track" is in degrees, but createQuaternionFromYaw expects
     // radians.
@@ -149,7 +140,7 @@ namespace mapviz_plugins
     stamped_point.orientation =
         tf::createQuaternionFromYaw((-gps->track * (M_PI / 180.0)) + M_PI_2);
 
-    pushPoint( std::move( stamped_point) );
+    pushWgs84Point(std::move(stamped_point), gps->latitude, gps->longitude);
   }
 
   void GpsPlugin::PrintError(const std::string& message)
@@ -184,7 +175,11 @@ namespace mapviz_plugins
 
   void GpsPlugin::Draw(double x, double y, double scale)
   {
-    if (DrawPoints(scale))
+    if (!localXyInitialized())
+    {
+      PrintWarning("Waiting for the LocalXY origin.");
+    }
+    else if (DrawPoints(scale))
     {
       PrintInfo("OK");
     }
@@ -30,6 +30,8 @@
 #include <mapviz_plugins/grid_plugin.h>
 
 // C++ standard libraries
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -47,6 +49,15 @@ PLUGINLIB_EXPORT_CLASS(mapviz_plugins::GridPlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
+  // Lines closer together than this on screen are thinned out to every
+  // 2nd, 5th, 10th, 20th, ... line, so the number of lines drawn depends on
+  // the size of the canvas rather than the size of the grid.
+  static const double MIN_LINE_SPACING_PX = 8.0;
+
+  // The lines in between are still drawn, thinner and fainter, while they
+  // are at least this far apart.
+  static const double MIN_MINOR_LINE_SPACING_PX = 3.0;
+
   GridPlugin::GridPlugin() :
     config_widget_(new QWidget()),
     alpha_(1.0),
@@ -54,7 +65,8 @@ namespace mapviz_plugins
     size_(1),
     rows_(1),
     columns_(1),
-    transformed_(false)
+    transformed_(false),
+    rigid_(true)
   {
     ui_.setupUi(config_widget_);
 
@@ -125,36 +137,26 @@ namespace mapviz_plugins
   void GridPlugin::SetX(double x)
   {
     top_left_.setX(x);
-
-    RecalculateGrid();
   }
 
   void GridPlugin::SetY(double y)
   {
     top_left_.setY(y);
-
-    RecalculateGrid();
   }
 
   void GridPlugin::SetSize(double size)
   {
     size_ = size;
-
-    RecalculateGrid();
   }
 
   void GridPlugin::SetRows(int rows)
   {
     rows_ = rows;
-
-    RecalculateGrid();
   }
 
   void GridPlugin::SetColumns(int columns)
   {
     columns_ = columns;
-
-    RecalculateGrid();
   }
 
   void GridPlugin::SelectFrame()
@@ -172,8 +174,6 @@ namespace mapviz_plugins
     source_frame_ = ui_.frame->text().toStdString();
 
     initialized_ = true;
-
-    RecalculateGrid();
   }
 
   void GridPlugin::PrintError(const std::string& message)
@@ -209,103 +209,194 @@ namespace mapviz_plugins
 
   void GridPlugin::Draw(double x, double y, double scale)
   {
-    if (transformed_)
+    if (!transformed_ || size_ <= 0.0 || rows_ <= 0 || columns_ <= 0)
     {
-      QColor color = ui_.color->color();
-      
-      glLineWidth(3);
-      glColor4d(color.redF(), color.greenF(), color.blueF(), alpha_);
-      glBegin(GL_LINES);
+      return;
+    }
 
-        std::list<tf::Point>::iterator transformed_left_it = transformed_left_points_.begin();
-        std::list<tf::Point>::iterator transformed_right_it = transformed_right_points_.begin();
-        for (; transformed_left_it != transformed_left_points_.end(); ++transformed_left_it)
-        {
-          glVertex2d(transformed_left_it->getX(), transformed_left_it->getY());
-          glVertex2d(transformed_right_it->getX(), transformed_right_it->getY());
+    tf::Transform transform(transform_.GetOrientation(), transform_.GetOrigin());
 
-          ++transformed_right_it;
-        }
+    // Find the part of the grid within a circle around the view, in the
+    // grid's own frame
+    double radius = 0.5 * scale * std::sqrt(
+        static_cast<double>(canvas_->width() * canvas_->width() +
+                            canvas_->height() * canvas_->height()));
+    tf::Point center;
+    if (rigid_)
+    {
+      center = transform.inverse() * tf::Point(x, y, 0);
+    }
+    else
+    {
+      // Scale the circle and the line spacing by how much the inverse
+      // transform stretches distances around the view center.
+      center = inverse_transform_ * tf::Point(x, y, 0);
+      double stretch = std::max(
+          center.distance(inverse_transform_ * tf::Point(x + radius, y, 0)),
+          center.distance(inverse_transform_ * tf::Point(x, y + radius, 0))) / radius;
+      radius *= stretch;
+      scale *= stretch;
+    }
+
+    double min_x = std::max(top_left_.x(), center.x() - radius);
+    double max_x = std::min(top_left_.x() + size_ * columns_, center.x() + radius);
+    double min_y = std::max(top_left_.y(), center.y() - radius);
+    double max_y = std::min(top_left_.y() + size_ * rows_, center.y() + radius);
+
+    major_vertices_.clear();
+    minor_vertices_.clear();
+    if (min_x <= max_x && min_y <= max_y)
+    {
+      // Pick the smallest step of 1, 2, 5, 10, 20, 50, ... lines that keeps
+      // lines far enough apart on screen
+      int64_t step = 1;
+      int64_t minor_step = 0;
+      for (int i = 0; size_ * step / scale < MIN_LINE_SPACING_PX && step < columns_ + rows_; i++)
+      {
+        minor_step = step;
+        step = (i % 3 == 1) ? step * 5 / 2 : step * 2;
+      }
+      if (minor_step > 0 && size_ * minor_step / scale < MIN_MINOR_LINE_SPACING_PX)
+      {
+        minor_step = 0;
+      }
+
+      AddLines(major_vertices_, true, min_x, max_x, min_y, max_y, step, 0);
+      AddLines(major_vertices_, false, min_y, max_y, min_x, max_x, step, 0);
+      if (minor_step > 0)
+      {
+        AddLines(minor_vertices_, true, min_x, max_x, min_y, max_y, minor_step, step);
+        AddLines(minor_vertices_, false, min_y, max_y, min_x, max_x, minor_step, step);
+      }
+    }
 
-        std::list<tf::Point>::iterator transformed_top_it = transformed_top_points_.begin();
-        std::list<tf::Point>::iterator transformed_bottom_it = transformed_bottom_points_.begin();
-        for (; transformed_top_it != transformed_top_points_.end(); ++transformed_top_it)
-        {
-          glVertex2d(transformed_top_it->getX(), transformed_top_it->getY());
-          glVertex2d(transformed_bottom_it->getX(), transformed_bottom_it->getY());
+    if (rigid_)
+    {
+      double model[16];
+      transform.getOpenGLMatrix(model);
+      glPushMatrix();
+      glMultMatrixd(model);
 
-          ++transformed_bottom_it;
-        }
+      DrawLines(minor_vertices_, 1, alpha_ * 0.5);
+      DrawLines(major_vertices_, 3, alpha_);
 
-      glEnd();
+      glPopMatrix();
+    }
+    else
+    {
+      TransformVertices(minor_vertices_);
+      TransformVertices(major_vertices_);
 
-      PrintInfo("OK");
+      DrawLines(minor_vertices_, 1, alpha_ * 0.5);
+      DrawLines(major_vertices_, 3, alpha_);
     }
+
+    PrintInfo("OK");
   }
 
-  void GridPlugin::RecalculateGrid()
+  void GridPlugin::AddLines(
+      std::vector<double>& vertices,
+      bool vertical,
+      double view_min,
+      double view_max,
+      double line_min,
+      double line_max,
+      int64_t step,
+      int64_t skip_step)
   {
-    transformed_ = false;
-
-    left_points_.clear();
-    right_points_.clear();
-    top_points_.clear();
-    bottom_points_.clear();
+    // Vertical lines are the columns, spaced along x; horizontal lines are
+    // the rows, spaced along y.
+    const double origin = vertical ? top_left_.x() : top_left_.y();
+    const int64_t count = vertical ? columns_ : rows_;
 
-    transformed_left_points_.clear();
-    transformed_right_points_.clear();
-    transformed_top_points_.clear();
-    transformed_bottom_points_.clear();
+    int64_t first = std::max<int64_t>(0, static_cast<int64_t>(std::ceil((view_min - origin) / size_)));
+    int64_t last = std::min<int64_t>(count, static_cast<int64_t>(std::floor((view_max - origin) / size_)));
 
-    // Set top and bottom
-    for (int c = 0; c <= columns_; c++)
+    for (int64_t i = (first + step - 1) / step * step; i <= last; i += step)
     {
-      tf::Point top_point(top_left_.getX() + c * size_, top_left_.getY(), 0);
-      top_points_.push_back(top_point);
-      transformed_top_points_.push_back(transform_ * top_point);
-
-      tf::Point bottom_point(top_left_.getX() + c * size_, top_left_.getY() + size_ * rows_, 0);
-      bottom_points_.push_back(bottom_point);
-      transformed_bottom_points_.push_back(transform_ * bottom_point);
+      if (skip_step != 0 && i % skip_step == 0)
+      {
+        continue;
+      }
+      AddLine(vertices, vertical, origin + i * size_, line_min, line_max);
     }
 
-    // Set left and right
-    for (int r = 0; r <= rows_; r++)
+    // The far edge of the grid is always drawn with the major lines
+    if (skip_step == 0 && first <= count && last == count && count % step != 0)
     {
-      tf::Point left_point(top_left_.getX(), top_left_.getY() + r * size_, 0);
-      left_points_.push_back(left_point);
-      transformed_left_points_.push_back(transform_ * left_point);
-
-      tf::Point right_point(top_left_.getX() + size_ * columns_, top_left_.getY() + r * size_, 0);
-      right_points_.push_back(right_point);
-      transformed_right_points_.push_back(transform_ * right_point);
+      AddLine(vertices, vertical, origin + count * size_, line_min, line_max);
     }
   }
 
-  void GridPlugin::Transform()
+  void GridPlugin::AddLine(
+      std::vector<double>& vertices,
+      bool vertical,
+      double position,
+      double line_min,
+      double line_max)
   {
-    transformed_ = false;
+    if (vertical)
+    {
+      vertices.push_back(position);
+      vertices.push_back(line_min);
+      vertices.push_back(position);
+      vertices.push_back(line_max);
+    }
+    else
+    {
+      vertices.push_back(line_min);
+      vertices.push_back(position);
+      vertices.push_back(line_max);
+      vertices.push_back(position);
+    }
+  }
 
-    if (GetTransform(ros::Time(), transform_))
+  void GridPlugin::DrawLines(const std::vector<double>& vertices, double width, double alpha)
+  {
+    if (vertices.empty())
     {
-      Transform(left_points_, transformed_left_points_);
-      Transform(right_points_, transformed_right_points_);
-      Transform(top_points_, transformed_top_points_);
-      Transform(bottom_points_, transformed_bottom_points_);
+      return;
+    }
+
+    QColor color = ui_.color->color();
+    glLineWidth(width);
+    glColor4d(color.redF(), color.greenF(), color.blueF(), alpha);
 
-      transformed_ = true;
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, &vertices[0]);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size() / 2));
+    glDisableClientState(GL_VERTEX_ARRAY);
+  }
+
+  void GridPlugin::TransformVertices(std::vector<double>& vertices)
+  {
+    for (size_t i = 0; i + 1 < vertices.size(); i += 2)
+    {
+      tf::Point point = transform_ * tf::Point(vertices[i], vertices[i + 1], 0);
+      vertices[i] = point.x();
+      vertices[i + 1] = point.y();
     }
   }
 
-  void GridPlugin::Transform(std::list<tf::Point>& src, std::list<tf::Point>& dst)
+  void GridPlugin::Transform()
   {
-    std::list<tf::Point>::iterator points_it = src.begin();
-    std::list<tf::Point>::iterator transformed_it = dst.begin();
-    for (; points_it != src.end() && transformed_it != dst.end(); ++points_it)
+    transformed_ = GetTransform(ros::Time(), transform_);
+    if (!transformed_)
     {
-      (*transformed_it) = transform_ * (*points_it);
+      return;
+    }
 
-      ++transformed_it;
+    // Check the grid's corners against the rigid part of the transform
+    tf::Transform transform(transform_.GetOrientation(), transform_.GetOrigin());
+    tf::Point far_corner = top_left_ + tf::Point(size_ * columns_, size_ * rows_, 0);
+    rigid_ =
+        (transform_ * top_left_).distance(transform * top_left_) < 1e-6 &&
+        (transform_ * far_corner).distance(transform * far_corner) < 1e-6;
+
+    if (!rigid_ && !tf_manager_->GetTransform(source_frame_, target_frame_, ros::Time(), inverse_transform_))
+    {
+      PrintError("No transform between " + target_frame_ + " and " + source_frame_);
+      transformed_ = false;
     }
   }
 
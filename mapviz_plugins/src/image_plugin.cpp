@@ -35,6 +35,7 @@
 
 // QT libraries
 #include <QDialog>
+#include <QImage>
 #include <QGLWidget>
 
 // ROS libraries
@@ -383,40 +384,7 @@ namespace mapviz_plugins
     }
 
     cv::resize(cv_image_->image, scaled_image_, cvSize2D32f(width, height), 0, 0, CV_INTER_AREA);
-  }
-
-  void ImagePlugin::DrawIplImage(cv::Mat *image)
-  {
-    // TODO(malban) glTexture2D may be more efficient than glDrawPixels
-
-    if (image == NULL || image->cols == 0 || image->rows == 0)
-    {
-      return;
-    }
-
-    GLenum format;
-    switch (image->channels())
-    {
-      case 1:
-        format = GL_LUMINANCE;
-        break;
-      case 2:
-        format = GL_LUMINANCE_ALPHA;
-        break;
-      case 3:
-        format = GL_BGR;
-        break;
-      default:
-        return;
-    }
-
-    glPixelZoom(1.0f, -1.0f);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glDrawPixels(image->cols, image->rows, format, GL_UNSIGNED_BYTE, image->ptr());
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-
-
-    PrintInfo("OK");
+    UpdateHud();
   }
 
   void ImagePlugin::Draw(double x, double y, double scale)
@@ -495,21 +463,39 @@ namespace mapviz_plugins
       y_pos = canvas_->height() - height - y_offset;
     }
 
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    glOrtho(0, canvas_->width(), canvas_->height(), 0, -0.5f, 0.5f);
-
-    glRasterPos2d(x_pos, y_pos);
+    // The image itself is drawn as a HUD overlay; see PaintHud().
+    hud_rect_ = QRect(static_cast<int>(x_pos), static_cast<int>(y_pos),
+                      scaled_image_.cols, scaled_image_.rows);
 
-    DrawIplImage(&scaled_image_);
-
-    glPopMatrix();
+    if (!scaled_image_.empty())
+    {
+      PrintInfo("OK");
+    }
 
     last_width_ = width;
     last_height_ = height;
   }
 
+  QRect ImagePlugin::HudRect()
+  {
+    return hud_rect_;
+  }
+
+  void ImagePlugin::PaintHud(QPainter* painter, const QSize& size)
+  {
+    if (scaled_image_.empty() || scaled_image_.type() != CV_8UC3)
+    {
+      return;
+    }
+
+    QImage image(scaled_image_.data,
+                 scaled_image_.cols,
+                 scaled_image_.rows,
+                 static_cast<int>(scaled_image_.step),
+                 QImage::Format_RGB888);
+    painter->drawImage(0, 0, image.rgbSwapped());
+  }
+
   void ImagePlugin::LoadConfig(const YAML::Node& node, const std::string& path)
   {
     // Note that image_transport should be loaded before the
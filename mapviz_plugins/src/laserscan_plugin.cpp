@@ -293,15 +293,17 @@ namespace mapviz_plugins
       has_message_ = false;
       PrintWarning("No messages received.");
 
-      laserscan_sub_.shutdown();
+      UnsubscribeLazily(laserscan_sub_);
 
       topic_ = topic;
       if (!topic.empty())
       {
-        laserscan_sub_ = node_.subscribe(topic_,
-                                         100,
-                                         &LaserScanPlugin::laserScanCallback,
-                                         this);
+        SubscribeLazily(laserscan_sub_, [this]() {
+          return node_.subscribe(topic_,
+                                 100,
+                                 &LaserScanPlugin::laserScanCallback,
+                                 this);
+        });
 
         ROS_INFO("Subscribing to %s", topic_.c_str());
       }
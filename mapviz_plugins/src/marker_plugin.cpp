@@ -28,6 +28,7 @@
 // *****************************************************************************
 
 #include <mapviz_plugins/marker_plugin.h>
+#include <mapviz_plugins/shared_message_cache.h>
 
 #include <mapviz/select_topic_dialog.h>
 
@@ -125,11 +126,11 @@ namespace mapviz_plugins
     connected_ = true;
     if (IS_INSTANCE(msg, visualization_msgs::Marker))
     {
-      handleMarker(*(msg->instantiate<visualization_msgs::Marker>()));
+      handleMarker(*SharedMessageCache::Instantiate<visualization_msgs::Marker>(msg));
     }
     else if (IS_INSTANCE(msg, visualization_msgs::MarkerArray))
     {
-      handleMarkerArray(*(msg->instantiate<visualization_msgs::MarkerArray>()));
+      handleMarkerArray(*SharedMessageCache::Instantiate<visualization_msgs::MarkerArray>(msg));
     }
     else
     {
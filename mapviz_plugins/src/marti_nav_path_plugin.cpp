@@ -29,6 +29,8 @@
 
 #include <mapviz_plugins/marti_nav_path_plugin.h>
 
+#include <cmath>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -46,6 +48,7 @@
 #include <swri_yaml_util/yaml_util.h>
 
 #include <mapviz/select_topic_dialog.h>
+#include <mapviz_plugins/shared_message_cache.h>
 
 namespace mapviz_plugins
 {
@@ -80,6 +83,15 @@ MartiNavPathPlugin::MartiNavPathPlugin()
                    this, SLOT(historyChanged()));
 }
 
+MartiNavPathPlugin::~MartiNavPathPlugin()
+{
+  if (canvas_)
+  {
+    // Allow the path buffers to release their GL resources
+    canvas_->makeCurrent();
+  }
+}
+
 bool MartiNavPathPlugin::Initialize(QGLWidget* canvas)
 {
   canvas_ = canvas;
@@ -92,7 +104,15 @@ void MartiNavPathPlugin::Shutdown()
 
 void MartiNavPathPlugin::historyChanged()
 {
-  items_.set_capacity(ui_.history_size->value());
+  size_t capacity = static_cast<size_t>(ui_.history_size->value());
+  if (items_.size() > capacity && canvas_)
+  {
+    canvas_->makeCurrent();
+  }
+  while (items_.size() > capacity)
+  {
+    items_.pop_front();
+  }
 }
 
 void MartiNavPathPlugin::setColorForDirection(const bool in_reverse)
@@ -101,42 +121,88 @@ void MartiNavPathPlugin::setColorForDirection(const bool in_reverse)
   glColor3f(color.redF(), color.greenF(), color.blueF());
 }
 
-static inline
-void drawArrow(const double x, const double y, const double yaw, const double L)
+void MartiNavPathPlugin::updatePoints(
+  PathGeometry& item,
+  const swri_transform_util::Transform* transform)
 {
-  double tip_x = x + std::cos(yaw)*L;
-  double tip_y = y + std::sin(yaw)*L;
+  std::vector<tf::Point> points;
+  points.reserve(item.path.points.size());
+  for (auto const &point : item.path.points)
+  {
+    tf::Point vertex(point.x, point.y, 0.0);
+    points.push_back(transform ? *transform * vertex : vertex);
+  }
 
-  double right_wing_x = tip_x + std::cos(yaw - M_PI*3.0/4.0)*L*0.25;
-  double right_wing_y = tip_y + std::sin(yaw - M_PI*3.0/4.0)*L*0.25;
+  // The buffer's origin has to be picked again when switching frames
+  if (item.points_transformed != (transform != NULL))
+  {
+    item.points.Clear();
+    item.points_transformed = (transform != NULL);
+  }
+  item.points.SetVertices(points);
+}
 
-  double left_wing_x = tip_x + std::cos(yaw + M_PI*3.0/4.0)*L*0.25;
-  double left_wing_y = tip_y + std::sin(yaw + M_PI*3.0/4.0)*L*0.25;
+void MartiNavPathPlugin::updateArrows(
+  PathGeometry& item,
+  const swri_transform_util::Transform* transform)
+{
+  item.arrow_length = ui_.arrow_length->value();
+  const double L = item.arrow_length;
 
-  glBegin(GL_LINES);
+  std::vector<tf::Point> vertices;
+  vertices.reserve(item.path.points.size() * 6);
+  for (auto const &point : item.path.points)
+  {
+    double tip_x = point.x + std::cos(point.yaw)*L;
+    double tip_y = point.y + std::sin(point.yaw)*L;
 
-  glVertex2f(x,y);
-  glVertex2f(tip_x,tip_y);
+    double right_wing_x = tip_x + std::cos(point.yaw - M_PI*3.0/4.0)*L*0.25;
+    double right_wing_y = tip_y + std::sin(point.yaw - M_PI*3.0/4.0)*L*0.25;
 
-  glVertex2f(tip_x,tip_y);
-  glVertex2f(right_wing_x, right_wing_y);
+    double left_wing_x = tip_x + std::cos(point.yaw + M_PI*3.0/4.0)*L*0.25;
+    double left_wing_y = tip_y + std::sin(point.yaw + M_PI*3.0/4.0)*L*0.25;
 
-  glVertex2f(tip_x, tip_y);
-  glVertex2f(left_wing_x, left_wing_y);
+    vertices.push_back(tf::Point(point.x, point.y, 0.0));
+    vertices.push_back(tf::Point(tip_x, tip_y, 0.0));
 
-  glEnd();
+    vertices.push_back(tf::Point(tip_x, tip_y, 0.0));
+    vertices.push_back(tf::Point(right_wing_x, right_wing_y, 0.0));
+
+    vertices.push_back(tf::Point(tip_x, tip_y, 0.0));
+    vertices.push_back(tf::Point(left_wing_x, left_wing_y, 0.0));
+  }
+
+  if (transform)
+  {
+    for (tf::Point& vertex : vertices)
+    {
+      vertex = *transform * vertex;
+    }
+  }
+
+  if (item.arrows_transformed != (transform != NULL))
+  {
+    item.arrows.Clear();
+    item.arrows_transformed = (transform != NULL);
+  }
+  item.arrows.SetVertices(vertices);
 }
 
-void MartiNavPathPlugin::Draw(double /*x*/, double /*y*/, double /*scale*/)
+void MartiNavPathPlugin::Draw(double x, double y, double scale)
 {
   std::map<std::string, swri_transform_util::Transform> transforms;
   PrintInfo("Ok");
 
+  // Paths are culled against a circle that encloses the view
+  double radius = 0.5 * scale * std::sqrt(
+      static_cast<double>(canvas_->width() * canvas_->width() +
+                          canvas_->height() * canvas_->height()));
+
   for (size_t i = 0; i < items_.size(); i++)
   {
-    const auto& item = items_[i];
+    PathGeometry& item = *items_[i];
 
-    std::string src_frame = item.header.frame_id.length() ? item.header.frame_id : target_frame_;
+    std::string src_frame = item.frame.length() ? item.frame : target_frame_;
     if (transforms.count(src_frame) == 0)
     {
       swri_transform_util::Transform transform;
@@ -152,61 +218,83 @@ void MartiNavPathPlugin::Draw(double /*x*/, double /*y*/, double /*scale*/)
       }
     }
 
+    // The path stays in its source frame on the GPU and is placed with a
+    // model matrix instead of transforming every point on every frame.
     const swri_transform_util::Transform &transform = transforms[src_frame];
+    tf::Transform model_transform(transform.GetOrientation(), transform.GetOrigin());
+
+    // Transforms from /wgs84 only have an origin, so a few of the points
+    // are checked against the rigid part of the transform.  If it doesn't
+    // match, the path is transformed on the CPU whenever the probes move.
+    bool rigid = true;
+    std::vector<tf::Vector3> probes;
+    const std::vector<marti_nav_msgs::PathPoint>& path_points = item.path.points;
+    if (!path_points.empty())
+    {
+      size_t indices[3] = { 0, path_points.size() / 2, path_points.size() - 1 };
+      for (size_t index : indices)
+      {
+        tf::Point point(path_points[index].x, path_points[index].y, 0.0);
+        probes.push_back(transform * point);
+        rigid = rigid && probes.back().distance(model_transform * point) < 1e-6;
+      }
+    }
 
-    marti_nav_msgs::Path path = items_[i]; //mutable copy
+    bool moved = !rigid && probes != item.probes;
+    item.probes = probes;
+    const swri_transform_util::Transform* point_transform = rigid ? NULL : &transform;
+    if (rigid == item.points_transformed || moved)
+    {
+      updatePoints(item, point_transform);
+    }
+    if (rigid == item.arrows_transformed || moved)
+    {
+      // Arrows are rebuilt the next time they are drawn
+      item.arrow_length = -1.0;
+    }
 
-    // transform the points
-    for (auto& pt: path.points)
+    tf::Point center(x, y, 0.0);
+    glPushMatrix();
+    if (rigid)
     {
-      // transform position
-      tf::Vector3 pt3(pt.x, pt.y, 0.0);
-      pt3 = transform*pt3;
-      pt.x = pt3.x();
-      pt.y = pt3.y();
-
-      // transform yaw
-      tf::Quaternion q = tf::createQuaternionFromYaw(pt.yaw);
-      q = transform*q;
-      pt.yaw = tf::getYaw(q);
+      center = model_transform.inverse() * center;
+
+      double model[16];
+      model_transform.getOpenGLMatrix(model);
+      glMultMatrixd(model);
     }
 
     if (ui_.draw_lines->isChecked())
     {
       glLineWidth(ui_.line_width->value());
 
-      setColorForDirection(path.in_reverse);
+      setColorForDirection(item.in_reverse);
 
-      glBegin(GL_LINE_STRIP);
-      for (auto const &point : path.points)
-      {
-        glVertex2f(point.x, point.y);
-      }
-      glEnd();
+      item.points.Draw(GL_LINE_STRIP, center.x(), center.y(), radius);
     }
     if (ui_.draw_points->isChecked())
     {
       glPointSize(2*ui_.line_width->value() + 1);
 
-      setColorForDirection(path.in_reverse);
+      setColorForDirection(item.in_reverse);
 
-      glBegin(GL_POINTS);
-      for (auto const &point : path.points)
-      {
-        glVertex2f(point.x, point.y);
-      }
-      glEnd();
+      item.points.Draw(GL_POINTS, center.x(), center.y(), radius);
     }
     if (ui_.draw_yaw->isChecked())
     {
-      glLineWidth(ui_.line_width->value());
-
-      setColorForDirection(path.in_reverse);
-      for (auto const &point : path.points)
+      if (item.arrow_length != ui_.arrow_length->value())
       {
-        drawArrow(point.x, point.y, point.yaw, ui_.arrow_length->value());
+        updateArrows(item, point_transform);
       }
+
+      glLineWidth(ui_.line_width->value());
+
+      setColorForDirection(item.in_reverse);
+
+      item.arrows.Draw(GL_LINES, center.x(), center.y(), radius);
     }
+
+    glPopMatrix();
   }
 }
 
@@ -375,6 +463,10 @@ void MartiNavPathPlugin::topicEdited()
   if (ui_.topic->text().toStdString() != topic_)
   {
     initialized_ = true;
+    if (canvas_)
+    {
+      canvas_->makeCurrent();
+    }
     items_.clear();
     topic_ = ui_.topic->text().toStdString();
 
@@ -393,12 +485,12 @@ void MartiNavPathPlugin::messageCallback(
 
   if (IS_INSTANCE(msg, marti_nav_msgs::Path))
   {
-    marti_nav_msgs::PathConstPtr msg_typed = msg->instantiate<marti_nav_msgs::Path>();
+    marti_nav_msgs::PathConstPtr msg_typed = SharedMessageCache::Instantiate<marti_nav_msgs::Path>(msg);
     handlePath(*msg_typed);
   }
   else if (IS_INSTANCE(msg, marti_nav_msgs::PathPoint))
   {
-    marti_nav_msgs::PathPointConstPtr msg_typed = msg->instantiate<marti_nav_msgs::PathPoint>();
+    marti_nav_msgs::PathPointConstPtr msg_typed = SharedMessageCache::Instantiate<marti_nav_msgs::PathPoint>(msg);
     handlePathPoint(*msg_typed);
   }
   else
@@ -415,7 +507,40 @@ void MartiNavPathPlugin::messageCallback(
 void MartiNavPathPlugin::handlePath(
   const marti_nav_msgs::Path &path)
 {
-  items_.push_back(path);
+  size_t capacity = static_cast<size_t>(ui_.history_size->value());
+  if (capacity == 0)
+  {
+    return;
+  }
+
+  // Once the history is full the oldest path's buffers are reused for the
+  // new path.  With a history of one, each path is diffed against the
+  // previous one and only the changed range is uploaded.
+  boost::shared_ptr<PathGeometry> item;
+  if (items_.size() >= capacity)
+  {
+    item = items_.front();
+    items_.pop_front();
+  }
+  else
+  {
+    item = boost::make_shared<PathGeometry>();
+    item->points_transformed = false;
+    item->arrows_transformed = false;
+  }
+
+  item->frame = path.header.frame_id;
+  item->in_reverse = path.in_reverse;
+  item->path = path;
+  // Arrows are rebuilt the next time they are drawn
+  item->arrow_length = -1.0;
+  item->probes.clear();
+
+  // The path is transformed on the CPU if its transform turns out not to
+  // be rigid when it is drawn.
+  updatePoints(*item, NULL);
+
+  items_.push_back(item);
 }
 
 void MartiNavPathPlugin::handlePathPoint(
@@ -30,6 +30,9 @@
 #include <mapviz_plugins/measuring_plugin.h>
 #include <mapviz/mapviz_plugin.h>
 
+// C++ standard libraries
+#include <cmath>
+
 // QT libraries
 #include <QDateTime>
 #include <QMouseEvent>
@@ -53,6 +56,8 @@ PLUGINLIB_EXPORT_CLASS(mapviz_plugins::MeasuringPlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
+// Maximum distance, in pixels, between a click and the vertex it selects.
+static const double PICK_RADIUS = 15.0;
 
 MeasuringPlugin::MeasuringPlugin():
   config_widget_(new QWidget()),
@@ -90,12 +95,17 @@ MeasuringPlugin::~MeasuringPlugin()
   if (map_canvas_)
   {
     map_canvas_->removeEventFilter(this);
+
+    // Allow the vertex buffer to release its GL resources
+    map_canvas_->makeCurrent();
   }
 }
 
 void MeasuringPlugin::Clear()
 {
   vertices_.clear();
+  vertex_buffer_.Clear();
+  picker_.Clear();
   measurements_.clear();
   ui_.measurement->setText(tr("Click on the map. Distance between clicks will appear here"));
   ui_.totaldistance->setText(tr("Click on the map. Total distance between clicks will appear here"));
@@ -110,6 +120,7 @@ QWidget* MeasuringPlugin::GetConfigWidget(QWidget* parent)
 
 bool MeasuringPlugin::Initialize(QGLWidget* canvas)
 {
+  canvas_ = canvas;
   map_canvas_ = static_cast< mapviz::MapCanvas* >(canvas);
   map_canvas_->installEventFilter(this);
 
@@ -143,30 +154,16 @@ bool MeasuringPlugin::eventFilter(QObject* object, QEvent* event)
 bool MeasuringPlugin::handleMousePress(QMouseEvent* event)
 {
   selected_point_ = -1;
-  int closest_point = 0;
-  double closest_distance = std::numeric_limits<double>::max();
 #if QT_VERSION >= 0x050000
   QPointF point = event->localPos();
 #else
   QPointF point = event->posF();
 #endif
   ROS_DEBUG("Map point: %f %f", point.x(), point.y());
-  for (size_t i = 0; i < vertices_.size(); i++)
-  {
-    tf::Vector3 vertex = vertices_[i];
-    QPointF transformed = map_canvas_->FixedFrameToMapGlCoord(QPointF(vertex.x(), vertex.y()));
-
-    double distance = QLineF(transformed, point).length();
-
-    if (distance < closest_distance)
-    {
-      closest_distance = distance;
-      closest_point = static_cast<int>(i);
-    }
-  }
+  int closest_point = picker_.Pick(map_canvas_->ViewTransform(), point, PICK_RADIUS);
   if (event->button() == Qt::LeftButton)
   {
-    if (closest_distance < 15)
+    if (closest_point >= 0)
     {
       selected_point_ = closest_point;
       return true;
@@ -185,10 +182,10 @@ bool MeasuringPlugin::handleMousePress(QMouseEvent* event)
   }
   else if (event->button() == Qt::RightButton)
   {
-    if (closest_distance < 15)
+    if (closest_point >= 0)
     {
       vertices_.erase(vertices_.begin() + closest_point);
-      DistanceCalculation(); //function to calculate distance
+      VerticesEdited();
       return true;
     }
   }
@@ -211,7 +208,7 @@ bool MeasuringPlugin::handleMouseRelease(QMouseEvent* event)
     vertices_[selected_point_].setX(position.x());
     vertices_[selected_point_].setY(position.y());
 
-    DistanceCalculation();
+    VerticesEdited();
 
     selected_point_ = -1;
 
@@ -241,7 +238,7 @@ bool MeasuringPlugin::handleMouseRelease(QMouseEvent* event)
       QPointF transformed = map_canvas_->MapGlCoordToFixedFrame(point);
       tf::Vector3 position(transformed.x(), transformed.y(), 0.0);
       vertices_.push_back(position);
-      DistanceCalculation(); //call to calculate distance
+      VerticesEdited();
     }
   }
   is_mouse_down_ = false;
@@ -249,6 +246,13 @@ bool MeasuringPlugin::handleMouseRelease(QMouseEvent* event)
   return false;
 }
 
+void MeasuringPlugin::VerticesEdited()
+{
+  vertex_buffer_.SetVertices(vertices_);
+  picker_.SetVertices(vertices_);
+  DistanceCalculation();
+}
+
 void MeasuringPlugin::DistanceCalculation()
 {
   double distance_instant = -1; //measurement between last two points
@@ -306,7 +310,7 @@ bool MeasuringPlugin::handleMouseMove(QMouseEvent* event)
     tf::Vector3 position(transformed.x(), transformed.y(), 0.0);
     vertices_[selected_point_].setY(position.y());
     vertices_[selected_point_].setX(position.x());
-    DistanceCalculation(); //function to calculate distance
+    VerticesEdited();
     return true;
   }// Let other plugins process this event too
   return false;
@@ -314,33 +318,18 @@ bool MeasuringPlugin::handleMouseMove(QMouseEvent* event)
 
 void MeasuringPlugin::Draw(double x, double y, double scale)
 {
+  const double radius = 0.5 * scale * std::sqrt(
+      static_cast<double>(canvas_->width() * canvas_->width() +
+                          canvas_->height() * canvas_->height()));
+
   glLineWidth(1);
   const QColor color = ui_.main_color->color();
   glColor4d(color.redF(), color.greenF(), color.blueF(), ui_.alpha->value()/2.0);
-  glBegin(GL_LINE_STRIP);
-
-  for (const auto& vertex: vertices_)
-  {
-    glVertex2d(vertex.x(), vertex.y());
-  }
-
-  glEnd();
-
-  glBegin(GL_LINES);
-
-  glColor4d(color.redF(), color.greenF(), color.blueF(), ui_.alpha->value()/2.0);
-
-  glEnd();
+  vertex_buffer_.Draw(GL_LINE_STRIP, x, y, radius);
 
   // Draw vertices
   glPointSize(9);
-  glBegin(GL_POINTS);
-
-  for (const auto& vertex: vertices_)
-  {
-    glVertex2d(vertex.x(), vertex.y());
-  }
-  glEnd();
+  vertex_buffer_.Draw(GL_POINTS, x, y, radius);
 
   PrintInfo("OK");
 }
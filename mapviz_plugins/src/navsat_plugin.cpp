@@ -118,10 +118,6 @@ namespace mapviz_plugins
   void NavSatPlugin::NavSatFixCallback(
       const sensor_msgs::NavSatFixConstPtr navsat)
   {
-    if (!tf_manager_->LocalXyUtil()->Initialized())
-    {
-      return;
-    }
     if (!has_message_)
     {
       initialized_ = true;
@@ -130,16 +126,10 @@ namespace mapviz_plugins
 
     StampedPoint stamped_point;
     stamped_point.stamp = navsat->header.stamp;
-
-    double x;
-    double y;
-    tf_manager_->LocalXyUtil()->ToLocalXy(navsat->latitude, navsat->longitude, x, y);
-
-    stamped_point.point = tf::Point(x, y, navsat->altitude);
+    stamped_point.point = tf::Point(0.0, 0.0, navsat->altitude);
     stamped_point.orientation = tf::createQuaternionFromYaw(0.0);
-    stamped_point.source_frame = tf_manager_->LocalXyUtil()->Frame();
 
-    pushPoint( std::move(stamped_point ) );
+    pushWgs84Point(std::move(stamped_point), navsat->latitude, navsat->longitude);
   }
 
   void NavSatPlugin::PrintError(const std::string& message)
@@ -173,7 +163,11 @@ namespace mapviz_plugins
 
   void NavSatPlugin::Draw(double x, double y, double scale)
   {
-    if (DrawPoints(scale))
+    if (!localXyInitialized())
+    {
+      PrintWarning("Waiting for the LocalXY origin.");
+    }
+    else if (DrawPoints(scale))
     {
       PrintInfo("OK");
     }
@@ -27,7 +27,18 @@
 //
 // *****************************************************************************
 
+#include <GL/glew.h>
 #include <mapviz_plugins/object_plugin.h>
+#include <mapviz_plugins/shared_message_cache.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// QT libraries
+#include <QFontMetrics>
+#include <QPainter>
 
 #include <mapviz/select_topic_dialog.h>
 
@@ -44,9 +55,17 @@ namespace mapviz_plugins
 #define IS_INSTANCE(msg, type) \
   (msg->getDataType() == ros::message_traits::datatype<type>())
 
+  // Width of the label atlas; labels are packed into rows of this width.
+  static const int LABEL_ATLAS_WIDTH = 1024;
+
   ObjectPlugin::ObjectPlugin() :
     config_widget_(new QWidget()),
-    connected_(false)
+    connected_(false),
+    has_message_(false),
+    has_vertex_origin_(false),
+    vbo_(0),
+    vertices_dirty_(false),
+    labels_dirty_(false)
   {
     ui_.setupUi(config_widget_);
 
@@ -72,6 +91,11 @@ namespace mapviz_plugins
 
   ObjectPlugin::~ObjectPlugin()
   {
+    if (canvas_ && vbo_ != 0)
+    {
+      canvas_->makeCurrent();
+      glDeleteBuffers(1, &vbo_);
+    }
   }
 
   void ObjectPlugin::SetColor(const QColor& color)
@@ -81,7 +105,19 @@ namespace mapviz_plugins
 
   void ObjectPlugin::ClearHistory()
   {
+    clearObjects();
+  }
+
+  void ObjectPlugin::clearObjects()
+  {
+    groups_.clear();
+    group_index_.clear();
     objects_.clear();
+    points_.clear();
+    vertices_.clear();
+    visible_objects_.clear();
+    label_atlas_ = QPixmap();
+    labels_dirty_ = false;
   }
 
   void ObjectPlugin::SelectTopic()
@@ -105,7 +141,7 @@ namespace mapviz_plugins
     if (topic != topic_)
     {
       initialized_ = false;
-      objects_.clear();
+      clearObjects();
       has_message_ = false;
       PrintWarning("No messages received.");
 
@@ -128,9 +164,9 @@ namespace mapviz_plugins
     connected_ = true;
     if (IS_INSTANCE(msg, marti_nav_msgs::TrackedObjectArray))
     {
-      objects_.clear();
+      clearObjects();
 
-      auto objs = msg->instantiate<marti_nav_msgs::TrackedObjectArray>();
+      auto objs = SharedMessageCache::Instantiate<marti_nav_msgs::TrackedObjectArray>(msg);
       objects_.reserve(objs->objects.size());
       for (const auto& obj: objs->objects)
       {
@@ -139,9 +175,9 @@ namespace mapviz_plugins
     }
     else if (IS_INSTANCE(msg, marti_nav_msgs::ObstacleArray))
     {
-      objects_.clear();
+      clearObjects();
 
-      auto objs = msg->instantiate<marti_nav_msgs::ObstacleArray>();
+      auto objs = SharedMessageCache::Instantiate<marti_nav_msgs::ObstacleArray>(msg);
       objects_.reserve(objs->obstacles.size());
       for (const auto& obj: objs->obstacles)
       {
@@ -151,123 +187,97 @@ namespace mapviz_plugins
     else
     {
       PrintError("Unknown message type: " + msg->getDataType());
+      return;
     }
-  }
 
-  void ObjectPlugin::handleObstacle(const marti_nav_msgs::Obstacle& obj, const std_msgs::Header& header)
-  {
-    if (!has_message_)
+    if (!objects_.empty() && !has_message_)
     {
       initialized_ = true;
       has_message_ = true;
     }
 
-    // Since orientation was not implemented, many markers publish
-    // invalid all-zero orientations, so we need to check for this
-    // and provide a default identity transform.
-    tf::Quaternion orientation(0.0, 0.0, 0.0, 1.0);
-    if (obj.pose.orientation.x ||
-        obj.pose.orientation.y ||
-        obj.pose.orientation.z ||
-        obj.pose.orientation.w)
-    {
-      orientation = tf::Quaternion(obj.pose.orientation.x,
-                                   obj.pose.orientation.y,
-                                   obj.pose.orientation.z,
-                                   obj.pose.orientation.w);
-    }
-
-    ObjectData data;
-    data.local_transform = swri_transform_util::Transform(
-      tf::Transform(
-        orientation,
-        tf::Vector3(obj.pose.position.x,
-                    obj.pose.position.y,
-                    obj.pose.position.z)));
-    data.source_frame = header.frame_id;
-    data.id = obj.id;
-    data.stamp = header.stamp;
-    data.transformed = false;
-    data.active = true;
-
-    swri_transform_util::Transform transform;
-    if (GetTransform(data.source_frame, data.stamp, transform))
-    {
-      data.transformed = true;
-    }
-
-    data.polygon.reserve(obj.polygon.size()+1);
-    for (auto& point: obj.polygon)
-    {
-      tf::Vector3 pt(point.x, point.y, point.z);
-      pt = data.local_transform*pt;
-      tf::Vector3 transformed = transform *pt;
-      data.polygon.push_back({pt, transformed});
-    }
-    if (data.polygon.size())
-    {
-      data.polygon.push_back(data.polygon.front());
-    }
-    objects_.push_back(data);
+    vertices_.resize(points_.size() * 2);
+    labels_dirty_ = true;
+    Transform();
   }
 
-  void ObjectPlugin::handleTrack(const marti_nav_msgs::TrackedObject &obj)
+  template <class PointT>
+  void ObjectPlugin::addObject(
+      const std::string& id,
+      bool active,
+      const std_msgs::Header& header,
+      const geometry_msgs::Pose& pose,
+      const std::vector<PointT>& polygon)
   {
-    if (!has_message_)
+    // Group objects by frame and stamp; obstacles all share the array's
+    // header and tracks usually share a few.
+    std::pair<std::map<std::pair<std::string, ros::Time>, size_t>::iterator, bool> inserted =
+        group_index_.insert(std::make_pair(std::make_pair(header.frame_id, header.stamp), groups_.size()));
+    size_t group = inserted.first->second;
+    if (inserted.second)
     {
-      initialized_ = true;
-      has_message_ = true;
+      ObjectGroup new_group;
+      new_group.source_frame = header.frame_id;
+      new_group.stamp = header.stamp;
+      new_group.transformed = false;
+      groups_.push_back(new_group);
     }
+    groups_[group].objects.push_back(objects_.size());
 
     // Since orientation was not implemented, many markers publish
     // invalid all-zero orientations, so we need to check for this
     // and provide a default identity transform.
     tf::Quaternion orientation(0.0, 0.0, 0.0, 1.0);
-    if (obj.pose.pose.orientation.x ||
-        obj.pose.pose.orientation.y ||
-        obj.pose.pose.orientation.z ||
-        obj.pose.pose.orientation.w)
+    if (pose.orientation.x ||
+        pose.orientation.y ||
+        pose.orientation.z ||
+        pose.orientation.w)
     {
-      orientation = tf::Quaternion(obj.pose.pose.orientation.x,
-                                   obj.pose.pose.orientation.y,
-                                   obj.pose.pose.orientation.z,
-                                   obj.pose.pose.orientation.w);
+      orientation = tf::Quaternion(pose.orientation.x,
+                                   pose.orientation.y,
+                                   pose.orientation.z,
+                                   pose.orientation.w);
     }
 
-    ObjectData data;
-    data.local_transform = swri_transform_util::Transform(
-      tf::Transform(
+    tf::Transform local_transform(
         orientation,
-        tf::Vector3(obj.pose.pose.position.x,
-                    obj.pose.pose.position.y,
-                    obj.pose.pose.position.z)));
-    data.stamp = obj.header.stamp;
-    data.source_frame = obj.header.frame_id;
-    data.id = std::to_string(obj.id);
-    data.transformed = false;
-    data.active = obj.active;
-
-    swri_transform_util::Transform transform;
-    if (GetTransform(data.source_frame, data.stamp, transform))
-    {
-      data.transformed = true;
-    }
+        tf::Vector3(pose.position.x,
+                    pose.position.y,
+                    pose.position.z));
 
-    data.polygon.reserve(obj.polygon.size()+1);
-    for (auto& point: obj.polygon)
+    ObjectData data;
+    data.id = id;
+    data.active = active;
+    data.group = group;
+    data.first = static_cast<GLint>(points_.size());
+    data.count = 0;
+    data.min_x = data.min_y = data.max_x = data.max_y = 0.0;
+
+    for (const auto& point: polygon)
     {
-      tf::Vector3 pt(point.x, point.y, point.z);
-      pt = data.local_transform*pt;
-      tf::Vector3 transformed = transform *pt;
-      data.polygon.push_back({pt, transformed});
+      points_.push_back(local_transform * tf::Vector3(point.x, point.y, point.z));
     }
-    if (data.polygon.size())
+    if (!polygon.empty())
     {
-      data.polygon.push_back(data.polygon.front());
+      // Close the polygon
+      tf::Point first = points_[data.first];
+      points_.push_back(first);
     }
+    data.count = static_cast<GLsizei>(points_.size() - data.first);
+
     objects_.push_back(data);
   }
 
+  void ObjectPlugin::handleObstacle(const marti_nav_msgs::Obstacle& obj, const std_msgs::Header& header)
+  {
+    addObject(obj.id, true, header, obj.pose, obj.polygon);
+  }
+
+  void ObjectPlugin::handleTrack(const marti_nav_msgs::TrackedObject &obj)
+  {
+    addObject(std::to_string(obj.id), obj.active, obj.header, obj.pose.pose, obj.polygon);
+  }
+
   void ObjectPlugin::PrintError(const std::string& message)
   {
     PrintErrorHelper(ui_.status, message);
@@ -300,35 +310,117 @@ namespace mapviz_plugins
 
   void ObjectPlugin::Draw(double x, double y, double scale)
   {
-    for (const auto& obj: objects_)
+    if (vertices_dirty_)
+    {
+      if (vbo_ == 0)
+      {
+        glGenBuffers(1, &vbo_);
+      }
+      glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+      glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(float),
+                   vertices_.empty() ? NULL : &vertices_[0], GL_DYNAMIC_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      vertices_dirty_ = false;
+    }
+
+    // Cull objects whose bounds don't intersect a circle around the view
+    const double radius = 0.5 * scale * std::sqrt(
+        static_cast<double>(canvas_->width() * canvas_->width() +
+                            canvas_->height() * canvas_->height()));
+
+    const bool show_inactive = ui_.show_inactive->isChecked();
+    visible_objects_.clear();
+    draw_firsts_.clear();
+    draw_counts_.clear();
+    for (size_t i = 0; i < objects_.size(); i++)
     {
-      if (!obj.transformed)
+      const ObjectData& obj = objects_[i];
+      if (obj.count == 0 || !groups_[obj.group].transformed)
       {
         continue;
       }
 
-      if (!obj.active && !ui_.show_inactive->isChecked())
+      double dx = x - std::max(obj.min_x, std::min(x, obj.max_x));
+      double dy = y - std::max(obj.min_y, std::min(y, obj.max_y));
+      if (dx * dx + dy * dy > radius * radius)
       {
         continue;
       }
 
-      glColor4f(color_.redF(), color_.greenF(), color_.blueF(), 1.0);
+      visible_objects_.push_back(i);
+      if (obj.active || show_inactive)
+      {
+        draw_firsts_.push_back(obj.first);
+        draw_counts_.push_back(obj.count);
+      }
+    }
+
+    if (!draw_firsts_.empty())
+    {
+      glPushMatrix();
+      glTranslated(vertex_origin_.x(), vertex_origin_.y(), 0.0);
 
+      glColor4f(color_.redF(), color_.greenF(), color_.blueF(), 1.0);
       glLineWidth(3.0);
-      glBegin(GL_LINE_STRIP);
 
-      for (const auto &point : obj.polygon) {
-        glVertex2d(
-          point.transformed_point.getX(),
-          point.transformed_point.getY());
-      }
+      glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glVertexPointer(2, GL_FLOAT, 0, 0);
+      glMultiDrawArrays(GL_LINE_STRIP, &draw_firsts_[0], &draw_counts_[0],
+                        static_cast<GLsizei>(draw_firsts_.size()));
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-      glEnd();
+      glPopMatrix();
+    }
 
+    if (has_message_)
+    {
       PrintInfo("OK");
     }
   }
 
+  void ObjectPlugin::updateLabelAtlas()
+  {
+    labels_dirty_ = false;
+
+    QFont font("Helvetica", 10);
+    QFontMetrics metrics(font);
+    const int height = metrics.height();
+
+    // Pack the labels into rows
+    int x = 0;
+    int y = 0;
+    for (auto& obj: objects_)
+    {
+      int width = std::min(metrics.width(QString::fromStdString(obj.id)) + 2, LABEL_ATLAS_WIDTH);
+      if (x + width > LABEL_ATLAS_WIDTH)
+      {
+        x = 0;
+        y += height;
+      }
+      obj.label = QRect(x, y, width, height);
+      x += width;
+    }
+
+    if (objects_.empty())
+    {
+      label_atlas_ = QPixmap();
+      return;
+    }
+
+    label_atlas_ = QPixmap(LABEL_ATLAS_WIDTH, y + height);
+    label_atlas_.fill(Qt::transparent);
+
+    QPainter painter(&label_atlas_);
+    painter.setFont(font);
+    painter.setPen(QPen(QBrush(QColor::fromRgbF(0, 0, 0, 1)), 1));
+    for (const auto& obj: objects_)
+    {
+      painter.drawText(obj.label, Qt::AlignLeft | Qt::AlignVCenter, QString::fromStdString(obj.id));
+    }
+  }
+
   void ObjectPlugin::Paint(QPainter* painter, double x, double y, double scale)
   {
     if (!ui_.show_ids->isChecked())
@@ -336,42 +428,41 @@ namespace mapviz_plugins
       return;
     }
 
-    // Most of the marker drawing is done using OpenGL commands, but text labels
-    // are rendered using a QPainter.  This is intended primarily as an example
-    // of how the QPainter works.
-    ros::Time now = ros::Time::now();
+    if (labels_dirty_)
+    {
+      updateLabelAtlas();
+    }
+
+    if (label_atlas_.isNull())
+    {
+      return;
+    }
 
     // We don't want the text to be rotated or scaled, but we do want it to be
     // translated appropriately.  So, we save off the current world transform
-    // and reset it; when we actually draw the text, we'll manually translate
-    // it to the right place.
+    // and reset it; when we actually draw the labels, we'll manually translate
+    // them to the right place.
     QTransform tf = painter->worldTransform();
-    QFont font("Helvetica", 10);
-    painter->setFont(font);
     painter->save();
     painter->resetTransform();
 
-    for (const auto& obj: objects_)
+    // The label of each object is drawn at the first point of its polygon;
+    // all of them are drawn from the atlas in one call.
+    std::vector<QPainter::PixmapFragment> fragments;
+    fragments.reserve(visible_objects_.size());
+    for (size_t index: visible_objects_)
     {
-      if (!obj.transformed)
-      {
-        continue;
-      }
-
-      QPen pen(QBrush(QColor::fromRgbF(0, 0, 0, 1)), 1);
-      painter->setPen(pen);
-
-      const StampedPoint& rosPoint = obj.polygon.front();
-      QPointF point = tf.map(QPointF(rosPoint.transformed_point.x(),
-                                     rosPoint.transformed_point.y()));
-
-      auto text = QString::fromStdString(obj.id);
-      // Get bounding rectangle
-      QRectF rect(point, QSizeF(10,10));
-      rect = painter->boundingRect(rect, Qt::AlignLeft | Qt::AlignHCenter, text);
-      painter->drawText(rect, text);
+      const ObjectData& obj = objects_[index];
+      QPointF point = tf.map(QPointF(
+          vertex_origin_.x() + vertices_[obj.first * 2],
+          vertex_origin_.y() + vertices_[obj.first * 2 + 1]));
+      QPointF center = point + QPointF(obj.label.width() / 2.0, obj.label.height() / 2.0);
+      fragments.push_back(QPainter::PixmapFragment::create(center, obj.label));
+    }
 
-      PrintInfo("OK");
+    if (!fragments.empty())
+    {
+      painter->drawPixmapFragments(&fragments[0], static_cast<int>(fragments.size()), label_atlas_);
     }
 
     painter->restore();
@@ -379,22 +470,70 @@ namespace mapviz_plugins
 
   void ObjectPlugin::Transform()
   {
-    for (auto& obj: objects_)
+    if (vertex_frame_ != target_frame_)
+    {
+      // Start over relative to a point in the new frame
+      vertex_frame_ = target_frame_;
+      has_vertex_origin_ = false;
+      for (auto& group: groups_)
+      {
+        group.transformed = false;
+      }
+    }
+
+    for (auto& group: groups_)
     {
       swri_transform_util::Transform transform;
-      if (GetTransform(obj.source_frame, obj.stamp, transform))
+      if (!GetTransform(group.source_frame, group.stamp, transform))
+      {
+        group.transformed = false;
+        continue;
+      }
+
+      // Transforms from WGS84 aren't rigid, so changes are detected by
+      // comparing where a few points end up.
+      tf::Vector3 probes[3] = {
+        transform * tf::Vector3(0.0, 0.0, 0.0),
+        transform * tf::Vector3(1.0, 0.0, 0.0),
+        transform * tf::Vector3(0.0, 1.0, 0.0)
+      };
+      if (group.transformed &&
+          probes[0] == group.probes[0] &&
+          probes[1] == group.probes[1] &&
+          probes[2] == group.probes[2])
       {
-        obj.transformed = true;
+        continue;
+      }
+      std::copy(probes, probes + 3, group.probes);
+      group.transformed = true;
 
-        for (auto &point : obj.polygon)
+      for (size_t index: group.objects)
+      {
+        ObjectData& obj = objects_[index];
+        for (GLsizei i = 0; i < obj.count; i++)
         {
-          point.transformed_point = transform * point.point;
+          tf::Point point = transform * points_[obj.first + i];
+          if (!has_vertex_origin_)
+          {
+            vertex_origin_ = point;
+            has_vertex_origin_ = true;
+          }
+
+          if (i == 0)
+          {
+            obj.min_x = obj.max_x = point.x();
+            obj.min_y = obj.max_y = point.y();
+          }
+          obj.min_x = std::min(obj.min_x, point.x());
+          obj.min_y = std::min(obj.min_y, point.y());
+          obj.max_x = std::max(obj.max_x, point.x());
+          obj.max_y = std::max(obj.max_y, point.y());
+
+          vertices_[(obj.first + i) * 2] = static_cast<float>(point.x() - vertex_origin_.x());
+          vertices_[(obj.first + i) * 2 + 1] = static_cast<float>(point.y() - vertex_origin_.y());
         }
       }
-      else
-      {
-        obj.transformed = false;
-      }
+      vertices_dirty_ = true;
     }
   }
 
@@ -240,15 +240,21 @@ namespace mapviz_plugins
     grid_.reset();
     raw_buffer_.clear();
 
-    grid_sub_.shutdown();
-    update_sub_.shutdown();
+    UnsubscribeLazily(grid_sub_);
+    UnsubscribeLazily(update_sub_);
 
     if (!topic.empty())
     {
-      grid_sub_   = node_.subscribe(topic, 10, &OccupancyGridPlugin::Callback, this);
+      // The grid is usually latched, so it is received again when a hidden
+      // display is shown.
+      SubscribeLazily(grid_sub_, [this, topic]() {
+        return node_.subscribe(topic, 10, &OccupancyGridPlugin::Callback, this);
+      });
       if( ui_.checkbox_update)
       {
-        update_sub_ = node_.subscribe(topic+ "_updates", 10, &OccupancyGridPlugin::CallbackUpdate, this);
+        SubscribeLazily(update_sub_, [this, topic]() {
+          return node_.subscribe(topic+ "_updates", 10, &OccupancyGridPlugin::CallbackUpdate, this);
+        });
       }
       ROS_INFO("Subscribing to %s", topic.c_str());
     }
@@ -257,11 +263,13 @@ namespace mapviz_plugins
   void OccupancyGridPlugin::upgradeCheckBoxToggled(bool)
   {
     const std::string topic = ui_.topic_grid->text().trimmed().toStdString();
-    update_sub_.shutdown();
+    UnsubscribeLazily(update_sub_);
 
     if( ui_.checkbox_update)
     {
-      update_sub_ = node_.subscribe(topic+ "_updates", 10, &OccupancyGridPlugin::CallbackUpdate, this);
+      SubscribeLazily(update_sub_, [this, topic]() {
+        return node_.subscribe(topic+ "_updates", 10, &OccupancyGridPlugin::CallbackUpdate, this);
+      });
     }
   }
 
@@ -498,6 +506,28 @@ namespace mapviz_plugins
     }
   }
 
+  bool OccupancyGridPlugin::SaveSnapshot(std::vector<uint8_t>& buffer) const
+  {
+    if (!grid_)
+    {
+      return false;
+    }
+
+    SerializeSnapshot(*grid_, buffer);
+    return true;
+  }
+
+  void OccupancyGridPlugin::LoadSnapshot(const uint8_t* data, size_t size)
+  {
+    nav_msgs::OccupancyGridPtr grid = boost::make_shared<nav_msgs::OccupancyGrid>();
+    if (DeserializeSnapshot(data, size, *grid))
+    {
+      // Use the latest transform since the original stamp is long gone
+      grid->header.stamp = ros::Time();
+      Callback(grid);
+    }
+  }
+
   void OccupancyGridPlugin::LoadConfig(const YAML::Node& node, const std::string& path)
   {
     if (node["topic"])
@@ -30,11 +30,15 @@
 #include <mapviz_plugins/odometry_plugin.h>
 
 // C++ standard libraries
+#include <cmath>
 #include <cstdio>
+#include <set>
+#include <utility>
 #include <vector>
 
 // QT libraries
 #include <QDialog>
+#include <QFontMetricsF>
 #include <QGLWidget>
 #include <QPainter>
 #include <QPalette>
@@ -54,8 +58,14 @@ PLUGINLIB_EXPORT_CLASS(mapviz_plugins::OdometryPlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
-  OdometryPlugin::OdometryPlugin() : config_widget_(new QWidget())
+  OdometryPlugin::OdometryPlugin() :
+    config_widget_(new QWidget()),
+    timestamp_font_("Helvetica", 10)
   {
+    // Labels are decluttered on a grid whose cells are the size of a
+    // typical timestamp string.
+    timestamp_cell_ = QFontMetricsF(timestamp_font_).size(Qt::TextSingleLine, "0000000000.00");
+
     ui_.setupUi(config_widget_);
     ui_.color->setColor(Qt::green);
 
@@ -75,6 +85,10 @@ namespace mapviz_plugins
                      SLOT(TopicEdited()));
     QObject::connect(ui_.positiontolerance, SIGNAL(valueChanged(double)), this,
                      SLOT(PositionToleranceChanged(double)));
+    QObject::connect(ui_.pointinterval, SIGNAL(valueChanged(double)), this,
+                     SLOT(PointIntervalChanged(double)));
+    QObject::connect(ui_.interpolate_pose, SIGNAL(clicked(bool)), this,
+                     SLOT(SetInterpolatePose(bool)));
     QObject::connect(ui_.buffersize, SIGNAL(valueChanged(int)), this,
                      SLOT(BufferSizeChanged(int)));
     QObject::connect(ui_.drawstyle, SIGNAL(activated(QString)), this,
@@ -251,33 +265,84 @@ namespace mapviz_plugins
   {
     //dont render any timestamps if the show_timestamps is set to 0
     int interval = ui_.show_timestamps->value();
-    if (interval == 0)
+    if (interval == 0 || points().empty())
     {
+      timestamp_labels_.clear();
       return;
     }
 
+    // Forget the labels of points that have dropped out of the buffer.
+    timestamp_labels_.erase(timestamp_labels_.begin(),
+                            timestamp_labels_.lower_bound(points().front().stamp));
+
     QTransform tf = painter->worldTransform();
-    QFont font("Helvetica", 10);
-    painter->setFont(font);
     painter->save();
     painter->resetTransform();
+    painter->setFont(timestamp_font_);
 
     //set the draw color for the text to be the same as the rest
     QPen pen(QBrush(ui_.color->color()), 1);
     painter->setPen(pen);
 
+    const QRectF viewport(painter->viewport());
+    const double ascent = QFontMetricsF(timestamp_font_).ascent();
+
+    // Screen-space cells already covered by a label this frame; a label that
+    // would overlap one of them is skipped.
+    std::set<std::pair<int, int> > occupied;
+
     int counter = 0;//used to alternate between rendering text on some points
     for (const StampedPoint& point: points())
     {
-      if (point.transformed && counter % interval == 0)//this renders a timestamp every 'interval' points
+      if (!point.transformed || counter++ % interval != 0)//this renders a timestamp every 'interval' points
+      {
+        continue;
+      }
+
+      QPointF qpoint = tf.map(QPointF(point.transformed_point.getX(),
+                                      point.transformed_point.getY()));
+
+      // Cull labels that are entirely off-screen before touching the cache.
+      QRectF rect(QPointF(qpoint.x(), qpoint.y() - ascent), timestamp_cell_);
+      if (!viewport.intersects(rect))
+      {
+        continue;
+      }
+
+      int left = static_cast<int>(std::floor(rect.left() / timestamp_cell_.width()));
+      int top = static_cast<int>(std::floor(rect.top() / timestamp_cell_.height()));
+      bool overlaps = false;
+      for (int i = left; i <= left + 1 && !overlaps; i++)
+      {
+        for (int j = top; j <= top + 1 && !overlaps; j++)
+        {
+          overlaps = occupied.count(std::make_pair(i, j)) > 0;
+        }
+      }
+      if (overlaps)
+      {
+        continue;
+      }
+      for (int i = left; i <= left + 1; i++)
+      {
+        for (int j = top; j <= top + 1; j++)
+        {
+          occupied.insert(std::make_pair(i, j));
+        }
+      }
+
+      std::map<ros::Time, QStaticText>::iterator label = timestamp_labels_.find(point.stamp);
+      if (label == timestamp_labels_.end())
       {
-        QPointF qpoint = tf.map(QPointF(point.transformed_point.getX(),
-                                        point.transformed_point.getY()));
         QString time;
         time.setNum(point.stamp.toSec(), 'g', 12);
-        painter->drawText(qpoint, time);
+        QStaticText text(time);
+        text.setTextFormat(Qt::PlainText);
+        text.prepare(QTransform(), timestamp_font_);
+        label = timestamp_labels_.insert(std::make_pair(point.stamp, text)).first;
       }
-      counter++;
+
+      painter->drawStaticText(rect.topLeft(), label->second);
     }
 
     painter->restore();
@@ -332,6 +397,20 @@ namespace mapviz_plugins
       PositionToleranceChanged(position_tolerance);
     }
 
+    if (node["point_interval"])
+    {
+      double point_interval = node["point_interval"].as<double>();
+      ui_.pointinterval->setValue(point_interval);
+      PointIntervalChanged(point_interval);
+    }
+
+    if (node["interpolate_pose"])
+    {
+      bool interpolate_pose = node["interpolate_pose"].as<bool>();
+      ui_.interpolate_pose->setChecked(interpolate_pose);
+      SetInterpolatePose(interpolate_pose);
+    }
+
     if (node["buffer_size"])
     {
       double buffer_size;
@@ -408,6 +487,10 @@ namespace mapviz_plugins
     emitter << YAML::Key << "position_tolerance" <<
                YAML::Value << positionTolerance();
 
+    emitter << YAML::Key << "point_interval" << YAML::Value << pointInterval();
+
+    emitter << YAML::Key << "interpolate_pose" << YAML::Value << interpolatePose();
+
     emitter << YAML::Key << "buffer_size" << YAML::Value << bufferSize();
 
     bool show_laps = ui_.show_laps->isChecked();
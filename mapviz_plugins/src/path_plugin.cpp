@@ -30,6 +30,7 @@
 #include <mapviz_plugins/path_plugin.h>
 
 // C++ standard libraries
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -48,10 +49,16 @@ PLUGINLIB_EXPORT_CLASS(mapviz_plugins::PathPlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
-  PathPlugin::PathPlugin() : config_widget_(new QWidget())
+  PathPlugin::PathPlugin() :
+    config_widget_(new QWidget()),
+    has_message_(false),
+    points_dirty_(false),
+    buffer_transformed_(false),
+    transformed_(false)
   {
     ui_.setupUi(config_widget_);
     ui_.path_color->setColor(Qt::green);
+    SetDrawStyle(LINES);
 
     // Set background white
     QPalette p(config_widget_->palette());
@@ -72,6 +79,11 @@ namespace mapviz_plugins
 
   PathPlugin::~PathPlugin()
   {
+    if (canvas_)
+    {
+      // Allow the path buffer to release its GL resources
+      canvas_->makeCurrent();
+    }
   }
 
   void PathPlugin::SelectTopic()
@@ -92,16 +104,22 @@ namespace mapviz_plugins
     if (topic != topic_)
     {
       initialized_ = false;
-      ClearPoints();
+      points_.clear();
+      path_buffer_.Clear();
+      points_dirty_ = false;
+      transformed_ = false;
       has_message_ = false;
+      path_.reset();
       PrintWarning("No messages received.");
 
-      path_sub_.shutdown();
+      UnsubscribeLazily(path_sub_);
 
       topic_ = topic;
       if (!topic.empty())
       {
-        path_sub_ = node_.subscribe(topic_, 1, &PathPlugin::pathCallback, this);
+        SubscribeLazily(path_sub_, [this]() {
+          return node_.subscribe(topic_, 1, &PathPlugin::pathCallback, this);
+        });
 
         ROS_INFO("Subscribing to %s", topic_.c_str());
       }
@@ -110,23 +128,43 @@ namespace mapviz_plugins
 
   void PathPlugin::pathCallback(const nav_msgs::PathConstPtr& path)
   {
+    path_ = path;
     if (!has_message_)
     {
       initialized_ = true;
       has_message_ = true;
     }
 
-    ClearPoints();
+    if (path->header.frame_id != source_frame_ || path->header.stamp != stamp_)
+    {
+      transformed_ = false;
+    }
+    source_frame_ = path->header.frame_id;
+    stamp_ = path->header.stamp;
+
+    // Planners often republish a nearly identical path; the buffer only
+    // uploads the part that actually changed.
+    points_.clear();
+    points_.reserve(path->poses.size());
+    for (const geometry_msgs::PoseStamped& pose: path->poses)
+    {
+      points_.push_back(tf::Point(pose.pose.position.x, pose.pose.position.y, 0));
+    }
+    points_dirty_ = true;
+  }
 
-    for (unsigned int i = 0; i < path->poses.size(); i++)
+  void PathPlugin::Transform()
+  {
+    if (!has_message_ || (transformed_ && transform_target_ == target_frame_))
     {
-      StampedPoint stamped_point;
-      stamped_point.stamp = path->header.stamp;
-      stamped_point.source_frame = path->header.frame_id;
-      stamped_point.point = tf::Point(path->poses[i].pose.position.x,
-                                      path->poses[i].pose.position.y, 0);
+      return;
+    }
 
-      pushPoint( std::move(stamped_point) );
+    transformed_ = GetTransform(source_frame_, stamp_, transform_);
+    transform_target_ = target_frame_;
+    if (!transformed_)
+    {
+      PrintError("No transform between " + source_frame_ + " and " + target_frame_);
     }
   }
 
@@ -161,19 +199,107 @@ namespace mapviz_plugins
 
   void PathPlugin::Draw(double x, double y, double scale)
   {
-    bool lines;
-    bool points;
-    QColor old_color = ui_.path_color->color();
-    QColor color = old_color.dark(200);
-    SetDrawStyle( LINES );
-    lines = DrawPoints(scale);
-    SetColor(color);
-    SetDrawStyle( POINTS );
-    points = DrawPoints(scale);
-    SetColor(old_color);
-    if (lines && points)
-    {
-      PrintInfo("OK");
+    if (!transformed_)
+    {
+      return;
+    }
+
+    tf::Transform transform(transform_.GetOrientation(), transform_.GetOrigin());
+
+    // Transforms from /wgs84 only have an origin, so they can't be applied
+    // as a model matrix.  A few of the points are checked against the
+    // rigid part of the transform to detect that case.
+    bool rigid = true;
+    std::vector<tf::Vector3> probes;
+    if (!points_.empty())
+    {
+      const tf::Point* probe_points[3] = {
+        &points_.front(), &points_[points_.size() / 2], &points_.back() };
+      for (const tf::Point* point: probe_points)
+      {
+        probes.push_back(transform_ * *point);
+        rigid = rigid && probes.back().distance(transform * *point) < 1e-6;
+      }
+    }
+
+    if (rigid && (points_dirty_ || buffer_transformed_))
+    {
+      if (buffer_transformed_)
+      {
+        path_buffer_.Clear();
+      }
+      path_buffer_.SetVertices(points_);
+      buffer_transformed_ = false;
+    }
+    else if (!rigid && (points_dirty_ || !buffer_transformed_ || probes != probes_))
+    {
+      std::vector<tf::Point> transformed;
+      transformed.reserve(points_.size());
+      for (const tf::Point& point: points_)
+      {
+        transformed.push_back(transform_ * point);
+      }
+
+      if (!buffer_transformed_)
+      {
+        path_buffer_.Clear();
+      }
+      path_buffer_.SetVertices(transformed);
+      buffer_transformed_ = true;
+    }
+    points_dirty_ = false;
+    probes_ = probes;
+
+    // Cull against a circle around the view in the buffer's frame
+    tf::Point center(x, y, 0);
+    double radius = 0.5 * scale * std::sqrt(
+        static_cast<double>(canvas_->width() * canvas_->width() +
+                            canvas_->height() * canvas_->height()));
+
+    glPushMatrix();
+    if (rigid)
+    {
+      center = transform.inverse() * center;
+
+      double model[16];
+      transform.getOpenGLMatrix(model);
+      glMultMatrixd(model);
+    }
+
+    QColor color = ui_.path_color->color();
+    glColor4d(color.redF(), color.greenF(), color.blueF(), 1.0);
+    glLineWidth(3);
+    path_buffer_.Draw(GL_LINE_STRIP, center.x(), center.y(), radius);
+
+    color = color.dark(200);
+    glColor4d(color.redF(), color.greenF(), color.blueF(), 1.0);
+    glPointSize(6);
+    path_buffer_.Draw(GL_POINTS, center.x(), center.y(), radius);
+
+    glPopMatrix();
+
+    PrintInfo("OK");
+  }
+
+  bool PathPlugin::SaveSnapshot(std::vector<uint8_t>& buffer) const
+  {
+    if (!path_)
+    {
+      return false;
+    }
+
+    SerializeSnapshot(*path_, buffer);
+    return true;
+  }
+
+  void PathPlugin::LoadSnapshot(const uint8_t* data, size_t size)
+  {
+    nav_msgs::PathPtr path = boost::make_shared<nav_msgs::Path>();
+    if (DeserializeSnapshot(data, size, *path))
+    {
+      // Use the latest transform since the original stamp is long gone
+      path->header.stamp = ros::Time();
+      pathCallback(path);
     }
   }
 
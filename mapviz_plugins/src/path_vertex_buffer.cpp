@@ -0,0 +1,240 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <GL/glew.h>
+#include <mapviz_plugins/path_vertex_buffer.h>
+
+// C++ standard libraries
+#include <algorithm>
+
+// QT libraries
+#include <QGLContext>
+
+namespace mapviz_plugins
+{
+  PathVertexBuffer::PathVertexBuffer() :
+    has_origin_(false),
+    vbo_(0),
+    capacity_(0),
+    dirty_(false),
+    dirty_begin_(0),
+    dirty_end_(0)
+  {
+  }
+
+  PathVertexBuffer::~PathVertexBuffer()
+  {
+    // The owning plugin is responsible for making the canvas context current
+    // before this is destroyed; without a context the buffer can't be freed.
+    if (vbo_ != 0 && QGLContext::currentContext() != NULL)
+    {
+      glDeleteBuffers(1, &vbo_);
+    }
+  }
+
+  void PathVertexBuffer::Clear()
+  {
+    vertices_.clear();
+    bounds_.clear();
+    has_origin_ = false;
+    dirty_ = false;
+  }
+
+  void PathVertexBuffer::SetVertices(const std::vector<tf::Point>& points)
+  {
+    if (!has_origin_ && !points.empty())
+    {
+      origin_ = points.front();
+      has_origin_ = true;
+    }
+
+    std::vector<float> vertices;
+    vertices.reserve(points.size() * 2);
+    for (const tf::Point& point: points)
+    {
+      vertices.push_back(point.x() - origin_.x());
+      vertices.push_back(point.y() - origin_.y());
+    }
+
+    size_t old_size = vertices_.size();
+    size_t new_size = vertices.size();
+
+    // Find the range between the unchanged prefix and the unchanged suffix.
+    // The suffix can only be reused if nothing was inserted or removed.
+    size_t begin = 0;
+    size_t common = std::min(old_size, new_size);
+    while (begin < common && vertices_[begin] == vertices[begin])
+    {
+      begin++;
+    }
+    begin -= begin % 2;
+
+    size_t end = new_size;
+    if (old_size == new_size)
+    {
+      while (end > begin && vertices_[end - 1] == vertices[end - 1])
+      {
+        end--;
+      }
+      end += end % 2;
+    }
+
+    vertices_.swap(vertices);
+
+    if (begin < end)
+    {
+      if (dirty_)
+      {
+        dirty_begin_ = std::min(dirty_begin_, begin);
+        dirty_end_ = std::max(dirty_end_, end);
+      }
+      else
+      {
+        dirty_begin_ = begin;
+        dirty_end_ = end;
+        dirty_ = true;
+      }
+    }
+    dirty_end_ = std::min(dirty_end_, new_size);
+
+    size_t chunk_count = (Size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    bounds_.resize(chunk_count);
+    if (chunk_count > 0 && (begin < end || old_size != new_size))
+    {
+      // A chunk's bounds also cover the first vertex of the next chunk, so a
+      // change to that vertex affects the previous chunk as well.
+      size_t first_vertex = begin / 2;
+      size_t first_chunk = first_vertex > 0 ? (first_vertex - 1) / CHUNK_SIZE : 0;
+      size_t last_chunk = chunk_count - 1;
+      if (old_size == new_size)
+      {
+        last_chunk = std::min(last_chunk, (end / 2) / CHUNK_SIZE);
+      }
+      UpdateBounds(std::min(first_chunk, last_chunk), last_chunk);
+    }
+  }
+
+  void PathVertexBuffer::UpdateBounds(size_t first_chunk, size_t last_chunk)
+  {
+    size_t count = Size();
+    for (size_t chunk = first_chunk; chunk <= last_chunk; chunk++)
+    {
+      size_t first = chunk * CHUNK_SIZE;
+      size_t last = std::min(count, (chunk + 1) * CHUNK_SIZE + 1);
+
+      Bounds& bounds = bounds_[chunk];
+      bounds.min_x = bounds.max_x = vertices_[first * 2];
+      bounds.min_y = bounds.max_y = vertices_[first * 2 + 1];
+      for (size_t i = first + 1; i < last; i++)
+      {
+        bounds.min_x = std::min(bounds.min_x, vertices_[i * 2]);
+        bounds.max_x = std::max(bounds.max_x, vertices_[i * 2]);
+        bounds.min_y = std::min(bounds.min_y, vertices_[i * 2 + 1]);
+        bounds.max_y = std::max(bounds.max_y, vertices_[i * 2 + 1]);
+      }
+    }
+  }
+
+  void PathVertexBuffer::Draw(GLenum mode, double x, double y, double radius)
+  {
+    if (vertices_.empty())
+    {
+      return;
+    }
+
+    if (vbo_ == 0)
+    {
+      glGenBuffers(1, &vbo_);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    if (vertices_.size() > capacity_)
+    {
+      // Grow geometrically so that a path that gets a little longer with
+      // every message doesn't reallocate the buffer each time.
+      capacity_ = std::max(vertices_.size(), capacity_ * 2);
+      glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+      glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_.size() * sizeof(float), vertices_.data());
+    }
+    else if (dirty_ && dirty_begin_ < dirty_end_)
+    {
+      glBufferSubData(GL_ARRAY_BUFFER,
+                      dirty_begin_ * sizeof(float),
+                      (dirty_end_ - dirty_begin_) * sizeof(float),
+                      &vertices_[dirty_begin_]);
+    }
+    dirty_ = false;
+
+    glPushMatrix();
+    glTranslated(origin_.x(), origin_.y(), 0.0);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, 0);
+
+    float center_x = x - origin_.x();
+    float center_y = y - origin_.y();
+    float radius2 = radius * radius;
+
+    // Draw each run of consecutive visible chunks with a single call.
+    size_t count = Size();
+    size_t chunk_count = bounds_.size();
+    size_t run_begin = 0;
+    bool in_run = false;
+    for (size_t chunk = 0; chunk <= chunk_count; chunk++)
+    {
+      bool visible = false;
+      if (chunk < chunk_count)
+      {
+        const Bounds& bounds = bounds_[chunk];
+        float dx = std::max(0.0f, std::max(bounds.min_x - center_x, center_x - bounds.max_x));
+        float dy = std::max(0.0f, std::max(bounds.min_y - center_y, center_y - bounds.max_y));
+        visible = dx * dx + dy * dy <= radius2;
+      }
+
+      if (visible && !in_run)
+      {
+        run_begin = chunk;
+        in_run = true;
+      }
+      else if (!visible && in_run)
+      {
+        // Line strips also need the first vertex of the next chunk to
+        // connect the runs' last segment.
+        size_t first = run_begin * CHUNK_SIZE;
+        size_t last = std::min(count, chunk * CHUNK_SIZE + (mode == GL_LINE_STRIP ? 1 : 0));
+        glDrawArrays(mode, static_cast<GLint>(first), static_cast<GLsizei>(last - first));
+        in_run = false;
+      }
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPopMatrix();
+  }
+}
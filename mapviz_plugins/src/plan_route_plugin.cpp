@@ -41,6 +41,7 @@
 #include <QPainter>
 #include <QPalette>
 #include <QStaticText>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <opencv2/core/core.hpp>
 
@@ -50,8 +51,6 @@
 #include <swri_route_util/util.h>
 #include <swri_transform_util/frames.h>
 
-#include <marti_nav_msgs/PlanRoute.h>
-
 // Declare plugin
 #include <pluginlib/class_list_macros.h>
 PLUGINLIB_EXPORT_CLASS(mapviz_plugins::PlanRoutePlugin, mapviz::MapvizPlugin)
@@ -66,6 +65,10 @@ namespace mapviz_plugins
     config_widget_(new QWidget()),
     map_canvas_(NULL),
     failed_service_(false),
+    has_queued_request_(false),
+    request_generation_(0),
+    sent_generation_(0),
+    requested_from_vehicle_(false),
     selected_point_(-1),
     is_mouse_down_(false),
     max_ms_(Q_INT64_C(500)),
@@ -92,6 +95,8 @@ namespace mapviz_plugins
                      SIGNAL(VisibleChanged(bool)),
                      this,
                      SLOT(VisibilityChanged(bool)));
+    QObject::connect(&plan_watcher_, SIGNAL(finished()), this,
+                     SLOT(HandlePlanResult()));
   }
 
   PlanRoutePlugin::~PlanRoutePlugin()
@@ -100,6 +105,7 @@ namespace mapviz_plugins
     {
       map_canvas_->removeEventFilter(this);
     }
+    plan_watcher_.waitForFinished();
   }
 
   void PlanRoutePlugin::VisibilityChanged(bool visible)
@@ -131,51 +137,150 @@ namespace mapviz_plugins
 
   void PlanRoutePlugin::PlanRoute()
   {
-    route_preview_ = sru::RoutePtr();
+    // Any result that is still on its way is for older waypoints, unless
+    // this is just a replan of the same ones.
     bool start_from_vehicle = ui_.start_from_vehicle->isChecked();
+    std::string service = ui_.service->text().toStdString();
+    if (start_from_vehicle != requested_from_vehicle_ ||
+        service != requested_service_ ||
+        !SameWaypoints(waypoints_, requested_waypoints_))
+    {
+      request_generation_++;
+      requested_from_vehicle_ = start_from_vehicle;
+      requested_service_ = service;
+      requested_waypoints_ = waypoints_;
+    }
+
     if (waypoints_.size() + start_from_vehicle < 2 || !Visible())
     {
+      route_preview_ = sru::RoutePtr();
+      has_queued_request_ = false;
       return;
     }
 
+    mnm::PlanRoute::Request request;
+    request.header.frame_id = stu::_wgs84_frame;
+    request.header.stamp = ros::Time::now();
+    request.plan_from_vehicle = static_cast<unsigned char>(start_from_vehicle);
+    request.waypoints = waypoints_;
+
+    if (plan_watcher_.isRunning())
+    {
+      queued_request_ = request;
+      has_queued_request_ = true;
+      return;
+    }
+
+    StartPlanning(request);
+  }
+
+  void PlanRoutePlugin::StartPlanning(const mnm::PlanRoute::Request& request)
+  {
+    // The client is kept between requests so that dragging a waypoint
+    // doesn't look up and connect to the service for every mouse move.
     std::string service = ui_.service->text().toStdString();
-    ros::ServiceClient client = node_.serviceClient<mnm::PlanRoute>(service);
+    if (service != service_ || !client_.isValid())
+    {
+      service_ = service;
+      client_ = node_.serviceClient<mnm::PlanRoute>(service_, true);
+    }
 
-    mnm::PlanRoute plan_route;
-    plan_route.request.header.frame_id = stu::_wgs84_frame;
-    plan_route.request.header.stamp = ros::Time::now();
-    plan_route.request.plan_from_vehicle = static_cast<unsigned char>(start_from_vehicle);
-    plan_route.request.waypoints = waypoints_;
+    sent_generation_ = request_generation_;
+    has_queued_request_ = false;
+    plan_watcher_.setFuture(
+        QtConcurrent::run(&PlanRoutePlugin::CallPlanner, client_, request));
+  }
 
-    if (client.call(plan_route))
+  PlanRoutePlugin::PlanResult PlanRoutePlugin::CallPlanner(
+      ros::ServiceClient client,
+      mnm::PlanRoute::Request request)
+  {
+    PlanResult result;
+    result.called = client.call(request, result.response);
+    return result;
+  }
+
+  void PlanRoutePlugin::HandlePlanResult()
+  {
+    PlanResult result = plan_watcher_.result();
+    if (!result.called)
     {
-      if (plan_route.response.success)
-      {
-        route_preview_ = boost::make_shared<sru::Route>(plan_route.response.route);
-        failed_service_ = false;
-      }
-      else
-      {
-        PrintError(plan_route.response.message);
-        failed_service_ = true;
-      }
+      // Reconnect on the next request in case the service restarted
+      client_.shutdown();
     }
-    else
+
+    if (has_queued_request_)
+    {
+      StartPlanning(queued_request_);
+      return;
+    }
+
+    if (sent_generation_ != request_generation_)
+    {
+      return;
+    }
+
+    if (!result.called)
     {
       PrintError("Failed to plan route.");
       failed_service_ = true;
     }
+    else if (result.response.success)
+    {
+      route_preview_ = boost::make_shared<sru::Route>(result.response.route);
+      failed_service_ = false;
+    }
+    else
+    {
+      PrintError(result.response.message);
+      failed_service_ = true;
+    }
   }
 
   void PlanRoutePlugin::Retry(const ros::TimerEvent& e)
   {
-    PlanRoute();
+    // Only replan after a failure, or to follow the vehicle when planning
+    // from it.  A request that is still in flight is left to finish.
+    if ((failed_service_ || ui_.start_from_vehicle->isChecked()) &&
+        !plan_watcher_.isRunning())
+    {
+      PlanRoute();
+    }
   }
 
   void PlanRoutePlugin::Clear()
   {
     waypoints_.clear();
     route_preview_ = sru::RoutePtr();
+    has_queued_request_ = false;
+    request_generation_++;
+    requested_waypoints_.clear();
+  }
+
+  bool PlanRoutePlugin::SameWaypoints(
+      const std::vector<geometry_msgs::Pose>& a,
+      const std::vector<geometry_msgs::Pose>& b)
+  {
+    if (a.size() != b.size())
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      if (a[i].position.x != b[i].position.x ||
+          a[i].position.y != b[i].position.y ||
+          a[i].position.z != b[i].position.z ||
+          a[i].orientation.x != b[i].orientation.x ||
+          a[i].orientation.y != b[i].orientation.y ||
+          a[i].orientation.z != b[i].orientation.z ||
+          a[i].orientation.w != b[i].orientation.w)
+      {
+        return false;
+      }
+    }
+
+    return true;
   }
 
   void PlanRoutePlugin::PrintError(const std::string& message)
@@ -32,6 +32,8 @@
 #include <swri_transform_util/frames.h>
 #include <swri_yaml_util/yaml_util.h>
 
+#include <mapviz/discovery_service.h>
+
 #include <boost/shared_ptr.hpp>
 
 // Declare plugin
@@ -195,8 +197,7 @@ namespace mapviz_plugins
 
   void PointClickPublisherPlugin::updateFrames()
   {
-    std::vector<std::string> frames;
-    tf_->getFrameStrings(frames);
+    std::vector<std::string> frames = mapviz::DiscoveryService::Instance().Frames();
 
     bool supports_wgs84 = tf_manager_->SupportsTransform(
         swri_transform_util::_local_xy_frame,
@@ -27,8 +27,11 @@
 //
 // *****************************************************************************
 
+#include <GL/glew.h>
 #include <mapviz_plugins/point_drawing_plugin.h>
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <list>
 
@@ -44,10 +47,14 @@
 
 namespace mapviz_plugins
 {
+  static const size_t MAX_PENDING_WGS84 = 10000;
+
   PointDrawingPlugin::PointDrawingPlugin()
       : arrow_size_(25),
         draw_style_(LINES),
         position_tolerance_(0.0),
+        point_interval_(0.0),
+        interpolate_pose_(false),
         buffer_size_(0),
         covariance_checked_(false),
         show_all_covariances_checked_(false),
@@ -58,7 +65,13 @@ namespace mapviz_plugins
         static_arrow_sizes_(false),
         use_latest_transforms_(false),
         single_frame_(true),
-        got_begin_(false)
+        laps_transformed_(true),
+        got_begin_(false),
+        lap_buffer_dirty_(false),
+        lap_vertex_vbo_(0),
+        lap_color_vbo_(0),
+        lap_vertex_count_(0),
+        local_xy_origin_(0)
   {
     QObject::connect(this,
                      SIGNAL(TargetFrameChanged(const std::string&)),
@@ -70,6 +83,16 @@ namespace mapviz_plugins
                      SLOT(ResetTransformedPoints()));
   }
 
+  PointDrawingPlugin::~PointDrawingPlugin()
+  {
+    if (canvas_ && lap_vertex_vbo_ != 0)
+    {
+      canvas_->makeCurrent();
+      glDeleteBuffers(1, &lap_vertex_vbo_);
+      glDeleteBuffers(1, &lap_color_vbo_);
+    }
+  }
+
   void PointDrawingPlugin::ClearHistory()
   {
     ROS_INFO("PointDrawingPlugin::ClearHistory()");
@@ -143,6 +166,7 @@ namespace mapviz_plugins
   void PointDrawingPlugin::SetDrawStyle(PointDrawingPlugin::DrawStyle style)
   {
      draw_style_ = style;
+     lap_buffer_dirty_ = true;
      DrawIcon();
   }
 
@@ -157,6 +181,16 @@ namespace mapviz_plugins
     position_tolerance_ = value;
   }
 
+  void PointDrawingPlugin::PointIntervalChanged(double value)
+  {
+    point_interval_ = value;
+  }
+
+  void PointDrawingPlugin::SetInterpolatePose(bool checked)
+  {
+    interpolate_pose_ = checked;
+  }
+
   void PointDrawingPlugin::LapToggled(bool checked)
   {
     lap_checked_ = checked;
@@ -180,30 +214,50 @@ namespace mapviz_plugins
 
   void PointDrawingPlugin::ResetTransformedPoints()
   {
-    for (auto& lap: laps_)
+    ResetTransformedPoints(true);
+  }
+
+  void PointDrawingPlugin::ResetTransformedPoints(bool reset_laps)
+  {
+    if (reset_laps)
     {
-      for (auto& point: lap)
+      for (auto& point: lap_points_)
       {
         point.transformed = false;
       }
+      laps_transformed_ = lap_points_.empty();
+      lap_buffer_dirty_ = true;
     }
     for (auto& point: points_)
     {
       point.transformed = false;
     }
     cur_point_.transformed = false;
+    prev_point_.transformed = false;
     Transform();
   }
 
   void PointDrawingPlugin::pushPoint(PointDrawingPlugin::StampedPoint stamped_point)
   {
+    prev_point_ = cur_point_;
+    prev_received_ = cur_received_;
     cur_point_ = stamped_point;
+    cur_received_ = ros::WallTime::now();
+
+    // High rate sources only add to the history once they have moved far
+    // enough and enough time has passed; the current point is always updated.
+    bool add_point = points_.empty();
+    if (!add_point)
+    {
+      double elapsed = (stamped_point.stamp - points_.back().stamp).toSec();
+      add_point =
+          stamped_point.point.distance(points_.back().point) >= position_tolerance_ &&
+          (elapsed >= point_interval_ || elapsed < 0.0);
+    }
 
-    if (points_.empty() ||
-        (stamped_point.point.distance(points_.back().point)) >=
-            (position_tolerance_))
+    if (add_point)
     {
-      points_.push_back(stamped_point);
+      points_.push_back(std::move(stamped_point));
     }
 
     if (buffer_size_ > 0)
@@ -218,6 +272,146 @@ namespace mapviz_plugins
   void PointDrawingPlugin::ClearPoints()
   {
     points_.clear();
+    pending_wgs84_.clear();
+  }
+
+  void PointDrawingPlugin::pushWgs84Point(
+      PointDrawingPlugin::StampedPoint stamped_point,
+      double latitude,
+      double longitude)
+  {
+    Wgs84Point point;
+    point.point = std::move(stamped_point);
+    point.latitude = latitude;
+    point.longitude = longitude;
+    pending_wgs84_.push_back(std::move(point));
+    if (pending_wgs84_.size() > MAX_PENDING_WGS84)
+    {
+      pending_wgs84_.pop_front();
+    }
+
+    UpdateLocalXy();
+  }
+
+  bool PointDrawingPlugin::localXyInitialized() const
+  {
+    return local_xy_origin_ != 0;
+  }
+
+  bool PointDrawingPlugin::UpdateLocalXy()
+  {
+    if (!local_xy_)
+    {
+      local_xy_ = mapviz::LocalXyConverter::Get(tf_manager_->LocalXyUtil());
+    }
+
+    int origin = local_xy_->Update();
+    if (origin == 0)
+    {
+      return false;
+    }
+
+    if (origin != local_xy_origin_)
+    {
+      int previous_origin = local_xy_origin_;
+      local_xy_origin_ = origin;
+      if (previous_origin != 0)
+      {
+        ReprojectPoints(previous_origin);
+      }
+    }
+
+    if (!pending_wgs84_.empty())
+    {
+      size_t count = pending_wgs84_.size();
+      std::vector<double> x(count);
+      std::vector<double> y(count);
+      for (size_t i = 0; i < count; i++)
+      {
+        x[i] = pending_wgs84_[i].latitude;
+        y[i] = pending_wgs84_[i].longitude;
+      }
+      local_xy_->ToLocalXy(count, x.data(), y.data(), x.data(), y.data());
+
+      std::string frame = local_xy_->Frame();
+      for (size_t i = 0; i < count; i++)
+      {
+        StampedPoint& point = pending_wgs84_[i].point;
+        point.point.setX(x[i]);
+        point.point.setY(y[i]);
+        point.source_frame = frame;
+        pushPoint(std::move(point));
+      }
+      pending_wgs84_.clear();
+    }
+
+    return true;
+  }
+
+  void PointDrawingPlugin::ReprojectPoints(int origin)
+  {
+    std::string frame = local_xy_->Frame();
+
+    std::vector<StampedPoint*> points;
+    for (auto& point: points_)
+    {
+      points.push_back(&point);
+    }
+    for (auto& point: lap_points_)
+    {
+      points.push_back(&point);
+    }
+    points.push_back(&cur_point_);
+    points.push_back(&prev_point_);
+
+    std::vector<tf::Point*> positions;
+    std::vector<tf::Quaternion*> orientations;
+    for (auto point: points)
+    {
+      if (point->source_frame != frame)
+      {
+        continue;
+      }
+      positions.push_back(&point->point);
+      for (auto& cov_point: point->cov_points)
+      {
+        positions.push_back(&cov_point);
+      }
+      orientations.push_back(&point->orientation);
+    }
+    if (got_begin_)
+    {
+      positions.push_back(&begin_);
+    }
+
+    size_t count = positions.size();
+    std::vector<double> x(count);
+    std::vector<double> y(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      x[i] = positions[i]->x();
+      y[i] = positions[i]->y();
+    }
+
+    double yaw = 0.0;
+    if (!local_xy_->Reproject(origin, count, x.data(), y.data(), &yaw))
+    {
+      return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+      positions[i]->setX(x[i]);
+      positions[i]->setY(y[i]);
+    }
+
+    tf::Quaternion rotation = tf::createQuaternionFromYaw(yaw);
+    for (auto orientation: orientations)
+    {
+      *orientation = rotation * (*orientation);
+    }
+
+    ResetTransformedPoints();
   }
 
   double PointDrawingPlugin::bufferSize() const
@@ -237,6 +431,70 @@ namespace mapviz_plugins
     return position_tolerance_;
   }
 
+  PointDrawingPlugin::DrawStyle PointDrawingPlugin::drawStyle() const
+  {
+    return draw_style_;
+  }
+
+  QColor PointDrawingPlugin::color() const
+  {
+    return color_;
+  }
+
+  int PointDrawingPlugin::arrowSize() const
+  {
+    return arrow_size_;
+  }
+
+  bool PointDrawingPlugin::staticArrowSizes() const
+  {
+    return static_arrow_sizes_;
+  }
+
+  double PointDrawingPlugin::pointInterval() const
+  {
+    return point_interval_;
+  }
+
+  bool PointDrawingPlugin::interpolatePose() const
+  {
+    return interpolate_pose_;
+  }
+
+  PointDrawingPlugin::StampedPoint PointDrawingPlugin::CurrentPoint() const
+  {
+    if (!interpolate_pose_ || !cur_point_.transformed || !prev_point_.transformed)
+    {
+      return cur_point_;
+    }
+
+    double period = (cur_received_ - prev_received_).toSec();
+    if (period <= 0.0)
+    {
+      return cur_point_;
+    }
+
+    // The displayed pose trails the newest sample by one message period so
+    // that it can move smoothly from the previous sample to the newest one at
+    // the display rate instead of jumping each time a message arrives.
+    double t = std::min(1.0, (ros::WallTime::now() - cur_received_).toSec() / period);
+
+    StampedPoint point = cur_point_;
+    if (cur_point_.stamp >= prev_point_.stamp)
+    {
+      point.stamp = prev_point_.stamp + (cur_point_.stamp - prev_point_.stamp) * t;
+    }
+    point.transformed_point =
+        prev_point_.transformed_point.lerp(cur_point_.transformed_point, t);
+    point.transformed_arrow_point =
+        prev_point_.transformed_arrow_point.lerp(cur_point_.transformed_arrow_point, t);
+    point.transformed_arrow_left =
+        prev_point_.transformed_arrow_left.lerp(cur_point_.transformed_arrow_left, t);
+    point.transformed_arrow_right =
+        prev_point_.transformed_arrow_right.lerp(cur_point_.transformed_arrow_right, t);
+    return point;
+  }
+
   const std::deque<PointDrawingPlugin::StampedPoint> &PointDrawingPlugin::points() const
   {
     return points_;
@@ -257,29 +515,28 @@ namespace mapviz_plugins
 
   bool PointDrawingPlugin::DrawPoints(double scale)
   {
-    if(use_latest_transforms_ || (scale_ != scale && draw_style_ == ARROWS && static_arrow_sizes_))
+    if (scale_ != scale && draw_style_ == ARROWS && static_arrow_sizes_)
     {
       ResetTransformedPoints();
     }
+    else if (use_latest_transforms_)
+    {
+      // With a single frame, Transform() only retransforms the completed
+      // laps when the latest transform has changed.
+      ResetTransformedPoints(!single_frame_);
+    }
     scale_ = scale;
     bool transformed = true;
     if (lap_checked_)
     {
       CollectLaps();
 
-      if (draw_style_ == ARROWS)
-      {
-        transformed &= DrawLapsArrows();
-      }
-      else
-      {
-        transformed &= DrawLaps();
-      }
+      transformed &= DrawLaps();
     }
     else if (buffer_size_ == INT_MAX)
     {
       buffer_size_ = buffer_holder_;
-      laps_.clear();
+      ClearLaps();
       got_begin_ = false;
     }
     if (draw_style_ == ARROWS)
@@ -311,8 +568,15 @@ namespace mapviz_plugins
       new_lap_ = true;
       if (points_.size() > 0)
       {
-        laps_.push_back(points_);
-        laps_[0].pop_back();
+        // The finished lap is moved onto the end of the lap trajectory and
+        // is never modified after this.
+        lap_points_.insert(lap_points_.end(),
+                           std::make_move_iterator(points_.begin()),
+                           std::make_move_iterator(points_.end()));
+        lap_ends_.push_back(lap_points_.size());
+        laps_transformed_ = false;
+        lap_buffer_dirty_ = true;
+
         points_.clear();
         points_.push_back(cur_point_);
       }
@@ -340,8 +604,16 @@ namespace mapviz_plugins
       glBegin(GL_POINTS);
     }
 
+    // The interpolated current point can trail the newest samples, so the
+    // strip ends at the last sample before it instead of doubling back.
+    StampedPoint current = CurrentPoint();
     for (const auto& pt : points_)
     {
+      if (interpolate_pose_ && current.transformed && pt.stamp > current.stamp)
+      {
+        continue;
+      }
+
       success &= pt.transformed;
       if (pt.transformed)
       {
@@ -349,10 +621,10 @@ namespace mapviz_plugins
       }
     }
 
-    if (cur_point_.transformed)
+    if (current.transformed)
     {
-      glVertex2d(cur_point_.transformed_point.getX(),
-                 cur_point_.transformed_point.getY());
+      glVertex2d(current.transformed_point.getX(),
+                 current.transformed_point.getY());
     }
 
     glEnd();
@@ -395,7 +667,7 @@ namespace mapviz_plugins
       success &= DrawArrow(pt);
     }
 
-    success &= DrawArrow(cur_point_);
+    success &= DrawArrow(CurrentPoint());
 
     glEnd();
 
@@ -407,6 +679,7 @@ namespace mapviz_plugins
     if (color != color_)
     {
       color_ = color;
+      lap_buffer_dirty_ = true;
       DrawIcon();
     }
   }
@@ -486,6 +759,11 @@ namespace mapviz_plugins
 
   void PointDrawingPlugin::Transform()
   {
+    if (local_xy_)
+    {
+      UpdateLocalXy();
+    }
+
     if (points_.empty())
     {
       return;
@@ -501,12 +779,22 @@ namespace mapviz_plugins
           TransformPoint(pt, transform);
         }
         TransformPoint(cur_point_, transform);
-        for (auto &lap : laps_)
+        if (!prev_point_.source_frame.empty())
         {
-          for (auto &pt : lap)
+          TransformPoint(prev_point_, transform);
+        }
+        if (!laps_transformed_ ||
+            transform.GetOrigin() != lap_origin_ ||
+            transform.GetOrientation() != lap_orientation_)
+        {
+          for (auto &pt : lap_points_)
           {
             TransformPoint(pt, transform);
           }
+          laps_transformed_ = true;
+          lap_origin_ = transform.GetOrigin();
+          lap_orientation_ = transform.GetOrientation();
+          lap_buffer_dirty_ = true;
         }
       }
       else
@@ -516,13 +804,13 @@ namespace mapviz_plugins
           pt.transformed = false;
         }
         cur_point_.transformed = false;
-        for (auto &lap : laps_)
+        prev_point_.transformed = false;
+        for (auto &pt : lap_points_)
         {
-          for (auto &pt : lap)
-          {
-            pt.transformed = false;
-          }
+          pt.transformed = false;
         }
+        laps_transformed_ = lap_points_.empty();
+        lap_buffer_dirty_ = true;
         PrintError("No transform between " + points_.front().source_frame + " and " +
                    target_frame_);
       }
@@ -537,15 +825,23 @@ namespace mapviz_plugins
       }
 
       transformed = transformed | TransformPoint(cur_point_);
-      if (laps_.size() > 0)
+      if (!prev_point_.source_frame.empty())
       {
-        for (auto &lap : laps_)
+        TransformPoint(prev_point_);
+      }
+
+      // Completed laps never change, so once all of their points have been
+      // transformed they can be skipped until the transforms are reset.
+      if (!laps_transformed_)
+      {
+        laps_transformed_ = true;
+        for (auto &pt : lap_points_)
         {
-          for (auto &pt : lap)
-          {
-            transformed = transformed | TransformPoint(pt);
-          }
+          bool lap_point_transformed = TransformPoint(pt);
+          transformed = transformed | lap_point_transformed;
+          laps_transformed_ = laps_transformed_ && lap_point_transformed;
         }
+        lap_buffer_dirty_ = true;
       }
       if (!transformed)
       {
@@ -555,80 +851,134 @@ namespace mapviz_plugins
     }
   }
 
-  bool PointDrawingPlugin::DrawLaps()
+  void PointDrawingPlugin::ClearLaps()
   {
-    bool transformed = points_.size() != 0;
-    glColor4d(color_.redF(), color_.greenF(), color_.blueF(), 0.5);
-    glLineWidth(3);
-    QColor base_color = color_;
+    lap_points_.clear();
+    lap_ends_.clear();
+    laps_transformed_ = true;
+    lap_buffer_dirty_ = true;
+  }
 
-    for (size_t i = 0; i < laps_.size(); i++)
+  void PointDrawingPlugin::AddLapVertex(const tf::Point& point, const QColor& color)
+  {
+    lap_vertices_.push_back(point.getX());
+    lap_vertices_.push_back(point.getY());
+    lap_colors_.push_back(color.red());
+    lap_colors_.push_back(color.green());
+    lap_colors_.push_back(color.blue());
+    lap_colors_.push_back(color.alpha());
+  }
+
+  void PointDrawingPlugin::UpdateLapBuffer()
+  {
+    lap_vertices_.clear();
+    lap_colors_.clear();
+
+    // Every lap is expanded into independent line segments (or points) with
+    // the lap color stored per vertex, so laps don't need separate draw calls.
+    size_t begin = 0;
+    for (size_t i = 0; i < lap_ends_.size(); i++)
     {
-      UpdateColor(base_color, static_cast<int>(i));
-      if (draw_style_ == LINES)
-      {
-        glLineWidth(3);
-        glBegin(GL_LINE_STRIP);
-      }
-      else
-      {
-        glPointSize(6);
-        glBegin(GL_POINTS);
-      }
+      QColor color = LapColor(static_cast<int>(i));
+      color.setAlphaF(0.5);
 
-      for (const auto& pt : laps_[i])
+      const StampedPoint* previous = NULL;
+      for (size_t j = begin; j < lap_ends_[i]; j++)
       {
-        if (pt.transformed)
+        const StampedPoint& pt = lap_points_[j];
+        if (!pt.transformed)
+        {
+          continue;
+        }
+
+        if (draw_style_ == LINES)
+        {
+          if (previous)
+          {
+            AddLapVertex(previous->transformed_point, color);
+            AddLapVertex(pt.transformed_point, color);
+          }
+          previous = &pt;
+        }
+        else if (draw_style_ == POINTS)
         {
-          glVertex2d(pt.transformed_point.getX(),
-                     pt.transformed_point.getY());
+          AddLapVertex(pt.transformed_point, color);
+        }
+        else
+        {
+          AddLapVertex(pt.transformed_point, color);
+          AddLapVertex(pt.transformed_arrow_point, color);
+          AddLapVertex(pt.transformed_arrow_point, color);
+          AddLapVertex(pt.transformed_arrow_left, color);
+          AddLapVertex(pt.transformed_arrow_point, color);
+          AddLapVertex(pt.transformed_arrow_right, color);
         }
       }
-      glEnd();
+      begin = lap_ends_[i];
     }
 
-    if (draw_style_ == LINES)
+    if (lap_vertex_vbo_ == 0)
     {
-      glLineWidth(3);
-      glBegin(GL_LINE_STRIP);
+      glGenBuffers(1, &lap_vertex_vbo_);
+      glGenBuffers(1, &lap_color_vbo_);
     }
-    else
+
+    glBindBuffer(GL_ARRAY_BUFFER, lap_vertex_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, lap_vertices_.size() * sizeof(float), lap_vertices_.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, lap_color_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, lap_colors_.size() * sizeof(uint8_t), lap_colors_.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    lap_vertex_count_ = static_cast<GLsizei>(lap_vertices_.size() / 2);
+    lap_buffer_dirty_ = false;
+  }
+
+  bool PointDrawingPlugin::DrawLaps()
+  {
+    if (lap_buffer_dirty_)
     {
-      glPointSize(6);
-      glBegin(GL_POINTS);
+      UpdateLapBuffer();
     }
 
-    glColor4d(base_color.redF(), base_color.greenF(), base_color.blueF(), 0.5);
-
-    if (points_.size() > 0)
+    if (lap_vertex_count_ > 0)
     {
-      for (const auto &pt : points_)
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_COLOR_ARRAY);
+
+      glBindBuffer(GL_ARRAY_BUFFER, lap_vertex_vbo_);
+      glVertexPointer(2, GL_FLOAT, 0, 0);
+      glBindBuffer(GL_ARRAY_BUFFER, lap_color_vbo_);
+      glColorPointer(4, GL_UNSIGNED_BYTE, 0, 0);
+
+      if (draw_style_ == POINTS)
       {
-        transformed &= pt.transformed;
-        if (pt.transformed)
-        {
-          glVertex2d(pt.transformed_point.getX(),
-                     pt.transformed_point.getY());
-        }
+        glPointSize(6);
+        glDrawArrays(GL_POINTS, 0, lap_vertex_count_);
+      }
+      else
+      {
+        glLineWidth(draw_style_ == ARROWS ? 2 : 3);
+        glDrawArrays(GL_LINES, 0, lap_vertex_count_);
       }
+
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glDisableClientState(GL_COLOR_ARRAY);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    glEnd();
-    return transformed;
+    return laps_transformed_;
   }
 
-  void PointDrawingPlugin::UpdateColor(QColor base_color, int i)
+  QColor PointDrawingPlugin::LapColor(int i) const
   {
-      int hue = static_cast<int>(color_.hue() + (i + 1.0) * 10.0 * M_PI);
-      if (hue > 360)
-      {
-        hue %= 360;
-      }
-      int sat = color_.saturation();
-      int v = color_.value();
-      base_color.setHsv(hue, sat, v);
-      glColor4d(base_color.redF(), base_color.greenF(), base_color.blueF(),
-                0.5);
+    int hue = static_cast<int>(color_.hue() + (i + 1.0) * 10.0 * M_PI);
+    if (hue > 360)
+    {
+      hue %= 360;
+    }
+    QColor color;
+    color.setHsv(hue, color_.saturation(), color_.value());
+    return color;
   }
 
   void PointDrawingPlugin::DrawCovariance()
@@ -675,45 +1025,4 @@ namespace mapviz_plugins
       glEnd();
     }
   }
-
-  bool PointDrawingPlugin::DrawLapsArrows()
-  {
-    bool success = laps_.size() != 0 && points_.size() != 0;
-    glColor4d(color_.redF(), color_.greenF(), color_.blueF(), 0.5);
-    glLineWidth(2);
-    QColor base_color = color_;
-    if (laps_.size() != 0)
-    {
-      for (size_t i = 0; i < laps_.size(); i++)
-      {
-        UpdateColor(base_color, static_cast<int>(i));
-        for (const auto &pt : laps_[i])
-        {
-          glBegin(GL_LINE_STRIP);
-          success &= DrawArrow(pt);
-          glEnd();
-        }
-      }
-      glEnd();
-
-      int hue = static_cast<int>(color_.hue() + laps_.size() * 10.0 * M_PI);
-      int sat = color_.saturation();
-      int v = color_.value();
-      base_color.setHsv(hue, sat, v);
-      glColor4d(base_color.redF(), base_color.greenF(), base_color.blueF(),
-                0.5);
-    }
-
-    if (points_.size() > 0)
-    {
-      for (const auto& pt : points_)
-      {
-        glBegin(GL_LINE_STRIP);
-        success &= DrawArrow(pt);
-        glEnd();
-      }
-    }
-
-    return success;
-  }
 }
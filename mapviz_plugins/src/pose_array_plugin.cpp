@@ -28,15 +28,30 @@
  * POSSIBILITY OF SUCH DAMAGE.
  **/ 
 
+#include <GL/glew.h>
 #include <mapviz_plugins/pose_array_plugin.h>
 
+// C++ standard libraries
+#include <cmath>
+
 // Declare plugin
 #include <pluginlib/class_list_macros.h>
 PLUGINLIB_EXPORT_CLASS(mapviz_plugins::PoseArrayPlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
-  PoseArrayPlugin::PoseArrayPlugin() : config_widget_(new QWidget())
+  PoseArrayPlugin::PoseArrayPlugin() :
+    config_widget_(new QWidget()),
+    has_message_(false),
+    transformed_(false),
+    geometry_dirty_(true),
+    geometry_transformed_(false),
+    geometry_style_(ARROWS),
+    geometry_arrow_size_(0),
+    geometry_static_arrow_sizes_(false),
+    geometry_scale_(1.0),
+    vertex_vbo_(0),
+    vertex_count_(0)
   {
     ui_.setupUi(config_widget_);
 
@@ -70,6 +85,11 @@ namespace mapviz_plugins
 
   PoseArrayPlugin::~PoseArrayPlugin()
   {
+    if (canvas_ && vertex_vbo_ != 0)
+    {
+      canvas_->makeCurrent();
+      glDeleteBuffers(1, &vertex_vbo_);
+    }
   }
 
   void PoseArrayPlugin::SelectTopic()
@@ -90,16 +110,19 @@ namespace mapviz_plugins
     if (topic != topic_)
     {
       initialized_ = false;
-      ClearPoints();
+      poses_.clear();
+      geometry_dirty_ = true;
       has_message_ = false;
       PrintWarning("No messages received.");
 
-      pose_sub_.shutdown();
+      UnsubscribeLazily(pose_sub_);
 
       topic_ = topic;
       if (!topic.empty())
       {
-        pose_sub_ = node_.subscribe(topic_, 10, &PoseArrayPlugin::PoseArrayCallback, this);
+        SubscribeLazily(pose_sub_, [this]() {
+          return node_.subscribe(topic_, 10, &PoseArrayPlugin::PoseArrayCallback, this);
+        });
 
         ROS_INFO("Subscribing to %s", topic_.c_str());
       }
@@ -114,29 +137,160 @@ namespace mapviz_plugins
       has_message_ = true;
     }
 
-    ClearPoints();
+    source_frame_ = msg->header.frame_id;
+    stamp_ = msg->header.stamp;
+    transformed_ = false;
+    geometry_dirty_ = true;
 
-    StampedPoint stamped_point;
-    for (unsigned int i=0 ; i < msg->poses.size(); i++)
+    poses_.clear();
+    poses_.reserve(msg->poses.size());
+    if (!msg->poses.empty())
     {
-        stamped_point.stamp = msg->header.stamp;
-        stamped_point.source_frame = msg->header.frame_id;
-        geometry_msgs::Pose pose = msg->poses[i];
+      const geometry_msgs::Point& origin = msg->poses.front().position;
+      origin_ = tf::Point(origin.x, origin.y, origin.z);
+    }
+
+    tf::Point last;
+    for (const geometry_msgs::Pose& pose: msg->poses)
+    {
+      tf::Point point(pose.position.x, pose.position.y, pose.position.z);
+      if (!poses_.empty() && point.distance(last) < positionTolerance())
+      {
+        continue;
+      }
+      last = point;
+
+      tf::Quaternion orientation(
+              pose.orientation.x,
+              pose.orientation.y,
+              pose.orientation.z,
+              pose.orientation.w);
+
+      PoseInstance instance;
+      instance.x = point.x() - origin_.x();
+      instance.y = point.y() - origin_.y();
+      instance.valid = std::fabs(orientation.length2() - 1) <= 0.01;
+      instance.yaw = instance.valid ? tf::getYaw(orientation) : 0.0;
+      poses_.push_back(instance);
+    }
+  }
 
-        stamped_point.point = tf::Point(pose.position.x,
-                                        pose.position.y,
-                                        pose.position.z);
+  void PoseArrayPlugin::Transform()
+  {
+    if (poses_.empty())
+    {
+      return;
+    }
 
-        stamped_point.orientation = tf::Quaternion(
-                pose.orientation.x,
-                pose.orientation.y,
-                pose.orientation.z,
-                pose.orientation.w);
+    // The pose array has a single stamp, so its transform only needs to be
+    // looked up again when a new message arrives or the target frame changes.
+    if (transformed_ && transform_target_ == target_frame_)
+    {
+      return;
+    }
 
-        pushPoint( std::move( stamped_point) );
+    transformed_ = GetTransform(source_frame_, stamp_, transform_);
+    transform_target_ = target_frame_;
+    if (!transformed_)
+    {
+      PrintError("No transform between " + source_frame_ + " and " + target_frame_);
     }
   }
 
+  void PoseArrayPlugin::UpdateGeometry(double scale, bool transform_points)
+  {
+    geometry_transformed_ = transform_points;
+    geometry_style_ = drawStyle();
+    geometry_arrow_size_ = arrowSize();
+    geometry_static_arrow_sizes_ = staticArrowSizes();
+    geometry_scale_ = scale;
+
+    double size = static_cast<double>(geometry_arrow_size_);
+    if (geometry_static_arrow_sizes_)
+    {
+      size *= scale;
+    }
+    else
+    {
+      size /= 10.0;
+    }
+    double arrow_width = size / 5.0;
+    double head_length = size * 0.75;
+
+    vertices_.clear();
+    if (geometry_style_ == ARROWS)
+    {
+      vertices_.reserve(poses_.size() * 12);
+    }
+    else
+    {
+      vertices_.reserve(poses_.size() * 2);
+    }
+
+    // When transforming the points, the arrows are built in the target frame
+    // like the display did before it used a model matrix.
+    double yaw_offset = 0.0;
+    geometry_origin_ = origin_;
+    if (transform_points)
+    {
+      yaw_offset = tf::getYaw(transform_.GetOrientation());
+      geometry_origin_ = transform_ * origin_;
+    }
+
+    for (const PoseInstance& source_pose: poses_)
+    {
+      PoseInstance pose = source_pose;
+      if (transform_points)
+      {
+        tf::Point point = transform_ * (origin_ + tf::Point(pose.x, pose.y, 0.0));
+        pose.x = point.x() - geometry_origin_.x();
+        pose.y = point.y() - geometry_origin_.y();
+        pose.yaw += yaw_offset;
+      }
+
+      vertices_.push_back(pose.x);
+      vertices_.push_back(pose.y);
+
+      if (geometry_style_ != ARROWS)
+      {
+        continue;
+      }
+
+      // Poses with a malformed quaternion are drawn as a zero length arrow
+      double cos_yaw = 0.0;
+      double sin_yaw = 0.0;
+      if (pose.valid)
+      {
+        cos_yaw = std::cos(pose.yaw);
+        sin_yaw = std::sin(pose.yaw);
+      }
+
+      float tip_x = pose.x + cos_yaw * size;
+      float tip_y = pose.y + sin_yaw * size;
+      float left_x = pose.x + cos_yaw * head_length + sin_yaw * arrow_width;
+      float left_y = pose.y + sin_yaw * head_length - cos_yaw * arrow_width;
+      float right_x = pose.x + cos_yaw * head_length - sin_yaw * arrow_width;
+      float right_y = pose.y + sin_yaw * head_length + cos_yaw * arrow_width;
+
+      float segments[] = {
+        tip_x, tip_y,
+        tip_x, tip_y, left_x, left_y,
+        tip_x, tip_y, right_x, right_y };
+      vertices_.insert(vertices_.end(), segments, segments + 10);
+    }
+
+    if (vertex_vbo_ == 0)
+    {
+      glGenBuffers(1, &vertex_vbo_);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(float), vertices_.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    vertex_count_ = static_cast<GLsizei>(vertices_.size() / 2);
+    geometry_dirty_ = false;
+  }
+
   void PoseArrayPlugin::PrintError(const std::string& message)
   {
     PrintErrorHelper(ui_.status, message);
@@ -169,10 +323,75 @@ namespace mapviz_plugins
 
   void PoseArrayPlugin::Draw(double x, double y, double scale)
   {
-    if (DrawPoints(scale))
+    if (!transformed_ || poses_.empty())
+    {
+      return;
+    }
+
+    if (geometry_style_ != drawStyle() ||
+        geometry_arrow_size_ != arrowSize() ||
+        geometry_static_arrow_sizes_ != staticArrowSizes() ||
+        (geometry_style_ == ARROWS && geometry_static_arrow_sizes_ && geometry_scale_ != scale))
+    {
+      geometry_dirty_ = true;
+    }
+
+    // Check the first, middle and last poses against the rigid part of the
+    // transform to find transforms that can't be used as a model matrix.
+    tf::Transform transform(transform_.GetOrientation(), transform_.GetOrigin());
+    bool rigid = true;
+    std::vector<tf::Vector3> probes;
+    size_t indices[3] = { 0, poses_.size() / 2, poses_.size() - 1 };
+    for (size_t index: indices)
     {
-      PrintInfo("OK");
+      tf::Point point = origin_ + tf::Point(poses_[index].x, poses_[index].y, 0.0);
+      probes.push_back(transform_ * point);
+      rigid = rigid && probes.back().distance(transform * point) < 1e-6;
     }
+
+    if (rigid == geometry_transformed_ || (!rigid && probes != probes_))
+    {
+      geometry_dirty_ = true;
+    }
+    probes_ = probes;
+
+    if (geometry_dirty_)
+    {
+      UpdateGeometry(scale, !rigid);
+    }
+
+    glPushMatrix();
+    if (rigid)
+    {
+      double model[16];
+      transform.getOpenGLMatrix(model);
+      glMultMatrixd(model);
+    }
+    glTranslated(geometry_origin_.x(), geometry_origin_.y(), geometry_origin_.z());
+
+    QColor color = PointDrawingPlugin::color();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_vbo_);
+    glVertexPointer(2, GL_FLOAT, 0, 0);
+
+    if (geometry_style_ == ARROWS)
+    {
+      glColor4d(color.redF(), color.greenF(), color.blueF(), 0.5);
+      glLineWidth(4);
+      glDrawArrays(GL_LINES, 0, vertex_count_);
+    }
+    else
+    {
+      glColor4d(color.redF(), color.greenF(), color.blueF(), 1.0);
+      glPointSize(6);
+      glDrawArrays(GL_POINTS, 0, vertex_count_);
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPopMatrix();
+
+    PrintInfo("OK");
   }
 
   void PoseArrayPlugin::LoadConfig(const YAML::Node& node, const std::string& path)
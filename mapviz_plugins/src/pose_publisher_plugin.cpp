@@ -29,6 +29,7 @@
 
 #include <mapviz_plugins/pose_publisher_plugin.h>
 
+#include <mapviz/discovery_service.h>
 
 // Declare plugin
 #include <pluginlib/class_list_macros.h>
@@ -330,8 +331,7 @@ void PosePublisherPlugin::on_pushButtonPose_toggled(bool checked)
 
   void PosePublisherPlugin::updateFrames()
   {
-    std::vector<std::string> frames;
-    tf_->getFrameStrings(frames);
+    std::vector<std::string> frames = mapviz::DiscoveryService::Instance().Frames();
 
     bool supports_wgs84 = tf_manager_->SupportsTransform(
         swri_transform_util::_local_xy_frame,
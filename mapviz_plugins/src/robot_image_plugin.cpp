@@ -37,12 +37,11 @@
 // QT libraries
 #include <QGLWidget>
 #include <QPalette>
-#include <QImage>
 #include <QFileDialog>
+#include <QImageReader>
 
 // ROS libraries
 #include <ros/master.h>
-#include <ros/package.h>
 
 #include <mapviz/select_frame_dialog.h>
 
@@ -59,7 +58,6 @@ namespace mapviz_plugins
     offset_x_(0.0),
     offset_y_(0.0),
     image_ratio_(1.0),
-    texture_loaded_(false),
     transformed_(false)
   {
     ui_.setupUi(config_widget_);
@@ -74,8 +72,6 @@ namespace mapviz_plugins
     p3.setColor(QPalette::Text, Qt::red);
     ui_.status->setPalette(p3);
 
-    UpdateShape();
-
     QObject::connect(ui_.browse, SIGNAL(clicked()), this, SLOT(SelectFile()));
     QObject::connect(ui_.selectframe, SIGNAL(clicked()), this, SLOT(SelectFrame()));
     QObject::connect(ui_.frame, SIGNAL(editingFinished()), this, SLOT(FrameEdited()));
@@ -93,6 +89,11 @@ namespace mapviz_plugins
 
   RobotImagePlugin::~RobotImagePlugin()
   {
+    // The texture is freed with its last user, which needs the GL context
+    if (canvas_ != NULL)
+    {
+      canvas_->makeCurrent();
+    }
   }
 
   void RobotImagePlugin::SelectFile()
@@ -135,8 +136,6 @@ namespace mapviz_plugins
     ROS_INFO("Setting target frame to to %s", source_frame_.c_str());
 
     initialized_ = true;
-
-    UpdateShape();
   }
 
   void RobotImagePlugin::WidthChanged(double value)
@@ -148,25 +147,21 @@ namespace mapviz_plugins
     else if( ui_.ratio_original->isChecked()){
       ui_.height->setValue( width_ * image_ratio_ );
     }
-    UpdateShape();
   }
 
   void RobotImagePlugin::HeightChanged(double value)
   {
     height_ = value;
-    UpdateShape();
   }
 
   void RobotImagePlugin::OffsetXChanged(double value)
   {
     offset_x_ = value;
-    UpdateShape();
   }
 
   void RobotImagePlugin::OffsetYChanged(double value)
   {
     offset_y_ = value;
-    UpdateShape();
   }
 
   void RobotImagePlugin::RatioEqualToggled(bool toggled)
@@ -175,7 +170,6 @@ namespace mapviz_plugins
     {
       ui_.height->setValue(width_);
       ui_.height->setEnabled(false);
-      UpdateShape();
     }
   }
 
@@ -184,7 +178,6 @@ namespace mapviz_plugins
     if( toggled )
     {
       ui_.height->setEnabled(true);
-      UpdateShape();
     }
   }
 
@@ -194,20 +187,9 @@ namespace mapviz_plugins
     {
       ui_.height->setValue(width_*image_ratio_);
       ui_.height->setEnabled(false);
-      UpdateShape();
     }
   }
 
-  void RobotImagePlugin::UpdateShape()
-  {
-    double hw = 0.5*width_; //half width
-    double hh = 0.5*height_; //half height
-    top_left_ = tf::Point(offset_x_ - hw, offset_y_ + hh, 0);
-    top_right_ = tf::Point(offset_x_ + hw, offset_y_ + hh, 0);
-    bottom_left_ = tf::Point(offset_x_ - hw, offset_y_ - hh, 0);
-    bottom_right_ = tf::Point(offset_x_ + hw, offset_y_ - hh, 0);
-  }
-
   void RobotImagePlugin::PrintError(const std::string& message)
   {
     PrintErrorHelper(ui_.status, message);
@@ -239,22 +221,60 @@ namespace mapviz_plugins
 
   void RobotImagePlugin::Draw(double x, double y, double scale)
   {
-    if (texture_loaded_ && transformed_)
+    if (!texture_ && !image_path_.empty())
     {
-      glColor3f(1.0f, 1.0f, 1.0f);
-      glEnable(GL_TEXTURE_2D);
-      glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture_id_));
+      // Displays showing the same image share one texture
+      texture_ = TextureCache::Get(image_path_);
+      if (!texture_)
+      {
+        PrintError("Failed to load image.");
+        image_path_.clear();
+      }
+    }
 
-      glBegin(GL_QUADS);
+    if (texture_ && transformed_)
+    {
+      double hw = 0.5 * width_;
+      double hh = 0.5 * height_;
+      tf::Point corners[4] = {
+        tf::Point(offset_x_ - hw, offset_y_ + hh, 0.0),
+        tf::Point(offset_x_ + hw, offset_y_ + hh, 0.0),
+        tf::Point(offset_x_ + hw, offset_y_ - hh, 0.0),
+        tf::Point(offset_x_ - hw, offset_y_ - hh, 0.0) };
+
+      // Transforms from /wgs84 only have an origin, so the corners are
+      // checked against the rigid part of the transform.  If it doesn't
+      // match, the corners are transformed with the full transform.
+      tf::Transform transform(transform_.GetOrientation(), transform_.GetOrigin());
+      GLdouble vertices[8];
+      bool rigid = true;
+      for (int i = 0; i < 4; i++)
+      {
+        tf::Point corner = transform_ * corners[i];
+        vertices[i * 2] = corner.x();
+        vertices[i * 2 + 1] = corner.y();
+        rigid = rigid && corner.distance(transform * corners[i]) < 1e-6;
+      }
 
-      glTexCoord2f(0, 1); glVertex2d(top_left_transformed_.x(), top_left_transformed_.y());
-      glTexCoord2f(1, 1); glVertex2d(top_right_transformed_.x(), top_right_transformed_.y());
-      glTexCoord2f(1, 0); glVertex2d(bottom_right_transformed_.x(), bottom_right_transformed_.y());
-      glTexCoord2f(0, 0); glVertex2d(bottom_left_transformed_.x(), bottom_left_transformed_.y());
+      glColor3f(1.0f, 1.0f, 1.0f);
+      if (rigid)
+      {
+        double model[16];
+        transform.getOpenGLMatrix(model);
 
-      glEnd();
+        glPushMatrix();
+        glMultMatrixd(model);
+        glTranslated(offset_x_, offset_y_, 0.0);
+        glScaled(width_, height_, 1.0);
 
-      glDisable(GL_TEXTURE_2D);
+        TextureCache::DrawQuad(*texture_);
+
+        glPopMatrix();
+      }
+      else
+      {
+        TextureCache::DrawQuad(*texture_, vertices);
+      }
 
       PrintInfo("OK");
     }
@@ -264,13 +284,8 @@ namespace mapviz_plugins
   {
     transformed_ = false;
 
-    swri_transform_util::Transform transform;
-    if (GetTransform(ros::Time(), transform))
+    if (GetTransform(ros::Time(), transform_))
     {
-      top_left_transformed_ = transform * top_left_;
-      top_right_transformed_ = transform * top_right_;
-      bottom_left_transformed_ = transform * bottom_left_;
-      bottom_right_transformed_ = transform * bottom_right_;
       transformed_ = true;
     }
     else
@@ -282,79 +297,41 @@ namespace mapviz_plugins
   void RobotImagePlugin::LoadImage()
   {
     ROS_INFO("Loading image");
-    try
-    {
-      QImage nullImage;
-      image_ = nullImage;
-
-      if (texture_loaded_)
-      {
-        GLuint ids[1];
-        ids[0] = static_cast<GLuint>(texture_id_);
-        glDeleteTextures(1, &ids[0]);
-        texture_loaded_ = false;
-      }
 
-      const std::string prefix = "$(find ";
-      std::string real_filename;
-      size_t spos = filename_.find(prefix);
-      bool has_close = spos != -1 ? filename_.find(')', spos) != -1: false;
-      if (spos != -1 && spos + prefix.length() < filename_.size() && has_close)
-      {
-        std::string package = filename_.substr(spos + prefix.length());
-        package = package.substr(0, package.find(")"));
-
-        real_filename = ros::package::getPath(package) + filename_.substr(filename_.find(')')+1);
-      }
-      else
-      {
-        real_filename = filename_;
-      }
-
-
-      if (image_.load(real_filename.c_str()))
-      {
-        int width = image_.width();
-        int height = image_.height();
-        image_ratio_ = (double)height / (double)width;
-
-        float max_dim = std::max(width, height);
-        dimension_ = static_cast<int>(std::pow(2, std::ceil(std::log(max_dim) / std::log(2.0f))));
-
-        if (width != dimension_ || height != dimension_)
-        {
-          image_ = image_.scaled(dimension_, dimension_, Qt::IgnoreAspectRatio, Qt::FastTransformation);
-        }
-
-        image_ = QGLWidget::convertToGLFormat(image_);
-
-        GLuint ids[1];
-        glGenTextures(1, &ids[0]);
-        texture_id_ = ids[0];
-
-        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture_id_));
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimension_, dimension_, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_.bits());
+    // Release the old texture now; the new one is picked up on the next draw,
+    // when the GL context is current.
+    if (texture_ && canvas_ != NULL)
+    {
+      canvas_->makeCurrent();
+    }
+    texture_.reset();
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    image_path_ = TextureCache::ResolvePath(filename_);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Only the header is read when the format allows it; the pixels are
+    // loaded by the texture cache.
+    QImageReader reader(QString::fromStdString(image_path_));
+    QSize size = reader.size();
+    if (!size.isValid())
+    {
+      size = reader.read().size();
+    }
+    if (!size.isValid() || size.isEmpty())
+    {
+      image_path_.clear();
+      PrintError("Failed to load image.");
+      return;
+    }
 
-        texture_loaded_ = true;
-        if( ui_.ratio_original->isChecked() )
-        {
-          RatioOriginalToggled(true);
-        }
-      }
-      else
-      {
-        PrintError("Failed to load image.");
-      }
+    image_ratio_ = (double)size.height() / (double)size.width();
+    if( ui_.ratio_original->isChecked() )
+    {
+      RatioOriginalToggled(true);
     }
-    catch (const std::exception& e)
+
+    if (canvas_ != NULL)
     {
-      PrintError("Failed to load image.  Exception occured.");
+      canvas_->update();
     }
   }
 
@@ -413,7 +390,6 @@ namespace mapviz_plugins
       }
     }
 
-    UpdateShape();
     LoadImage();
     FrameEdited();
   }
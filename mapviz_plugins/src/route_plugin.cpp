@@ -30,6 +30,8 @@
 #include <mapviz_plugins/route_plugin.h>
 
 // C++ standard libraries
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <vector>
 
@@ -61,7 +63,12 @@ namespace stu = swri_transform_util;
 
 namespace mapviz_plugins
 {
-  RoutePlugin::RoutePlugin() : config_widget_(new QWidget()), draw_style_(LINES)
+  RoutePlugin::RoutePlugin() :
+    config_widget_(new QWidget()),
+    draw_style_(LINES),
+    route_dirty_(true),
+    position_index_(0),
+    segment_index_(0)
   {
     ui_.setupUi(config_widget_);
 
@@ -90,6 +97,11 @@ namespace mapviz_plugins
 
   RoutePlugin::~RoutePlugin()
   {
+    if (canvas_)
+    {
+      // Allow the route buffer to release its GL resources
+      canvas_->makeCurrent();
+    }
   }
 
   void RoutePlugin::DrawIcon()
@@ -170,6 +182,7 @@ namespace mapviz_plugins
     if (topic != topic_)
     {
       src_route_ = sru::Route();
+      route_dirty_ = true;
 
       route_sub_.shutdown();
 
@@ -212,6 +225,7 @@ namespace mapviz_plugins
   void RoutePlugin::RouteCallback(const marti_nav_msgs::RouteConstPtr& msg)
   {
     src_route_ = sru::Route(*msg);
+    route_dirty_ = true;
   }
 
   void RoutePlugin::PrintError(const std::string& message)
@@ -254,30 +268,28 @@ namespace mapviz_plugins
       return;
     }
 
-    sru::Route route = src_route_;
-    if (route.header.frame_id.empty())
+    std::string frame_id = src_route_.header.frame_id;
+    if (frame_id.empty())
     {
-      route.header.frame_id = "/wgs84";
+      frame_id = "/wgs84";
     }
 
     stu::Transform transform;
-    if (!GetTransform(route.header.frame_id, ros::Time(), transform))
+    if (!GetTransform(frame_id, ros::Time(), transform))
     {
       PrintError("Failed to transform route");
       return;
     }
 
-    sru::transform(route, transform, target_frame_);
-    sru::projectToXY(route);
-    sru::fillOrientations(route);
+    UpdateRoute(transform);
 
-    DrawRoute(route);
+    DrawRoute(x, y, scale);
 
     bool ok = true;
-    if (route.valid() && src_route_position_)
+    if (route_.valid() && src_route_position_)
     {
       sru::RoutePoint point;
-      if (sru::interpolateRoutePosition(point, route, *src_route_position_, true))
+      if (InterpolatePosition(point, *src_route_position_))
       {
         DrawRoutePoint(point);
       }
@@ -294,6 +306,114 @@ namespace mapviz_plugins
     }
   }
 
+  bool RoutePlugin::UpdateRoute(const stu::Transform& transform)
+  {
+    // The transform from WGS84 isn't rigid, so instead of comparing the
+    // transforms, a few route points are transformed and compared with
+    // where they ended up when the route was last rebuilt.
+    const size_t size = src_route_.points.size();
+    const size_t probe_indices[3] = { 0, size / 2, size - 1 };
+    std::vector<tf::Vector3> probes(3);
+    for (size_t i = 0; i < 3; i++)
+    {
+      probes[i] = transform * src_route_.points[probe_indices[i]].position();
+    }
+
+    if (!route_dirty_ && route_frame_ == target_frame_ && probes == probes_)
+    {
+      return false;
+    }
+
+    if (route_frame_ != target_frame_)
+    {
+      // Restart the vertex buffer relative to a point in the new frame
+      route_buffer_.Clear();
+    }
+
+    route_ = src_route_;
+    if (route_.header.frame_id.empty())
+    {
+      route_.header.frame_id = "/wgs84";
+    }
+
+    sru::transform(route_, transform, target_frame_);
+    sru::projectToXY(route_);
+    sru::fillOrientations(route_);
+
+    std::vector<tf::Point> points(route_.points.size());
+    distances_.resize(route_.points.size());
+    for (size_t i = 0; i < route_.points.size(); i++)
+    {
+      points[i] = route_.points[i].position();
+      distances_[i] = (i == 0) ? 0.0 : distances_[i - 1] + points[i].distance(points[i - 1]);
+    }
+    route_buffer_.SetVertices(points);
+
+    route_dirty_ = false;
+    route_frame_ = target_frame_;
+    probes_.swap(probes);
+    position_index_ = 0;
+    segment_index_ = 0;
+    return true;
+  }
+
+  bool RoutePlugin::InterpolatePosition(
+      sru::RoutePoint& point,
+      const marti_nav_msgs::RoutePosition& position)
+  {
+    const size_t size = route_.points.size();
+    if (size == 0)
+    {
+      return false;
+    }
+
+    // The position usually stays on the same point or moves to the next one
+    size_t index = 0;
+    if (position_index_ < size && route_.points[position_index_].id() == position.id)
+    {
+      index = position_index_;
+    }
+    else if (position_index_ + 1 < size && route_.points[position_index_ + 1].id() == position.id)
+    {
+      index = position_index_ + 1;
+    }
+    else if (!route_.findPointId(index, position.id))
+    {
+      return false;
+    }
+    position_index_ = index;
+
+    if (size == 1)
+    {
+      point = route_.points[0];
+      return true;
+    }
+
+    // Walk from the last segment to the one containing the position; past
+    // either end of the route, the first or last segment is extrapolated.
+    const double distance = distances_[index] + position.distance;
+    size_t segment = std::min(segment_index_, size - 2);
+    while (segment > 0 && distance < distances_[segment])
+    {
+      segment--;
+    }
+    while (segment + 2 < size && distance >= distances_[segment + 1])
+    {
+      segment++;
+    }
+    segment_index_ = segment;
+
+    const sru::RoutePoint& p0 = route_.points[segment];
+    const sru::RoutePoint& p1 = route_.points[segment + 1];
+    const double length = distances_[segment + 1] - distances_[segment];
+    const double t = (length > 0.0) ? (distance - distances_[segment]) / length : 0.0;
+
+    point = (t < 0.5) ? p0 : p1;
+    point.setPosition(p0.position().lerp(p1.position(), t));
+    point.setOrientation(p0.orientation().slerp(p1.orientation(), std::max(0.0, std::min(1.0, t))));
+    return true;
+  }
+
   void RoutePlugin::DrawStopWaypoint(double x, double y)
   {
     const double a = 2;
@@ -315,28 +435,25 @@ namespace mapviz_plugins
     glEnd();
   }
 
-  void RoutePlugin::DrawRoute(const sru::Route& route)
+  void RoutePlugin::DrawRoute(double x, double y, double scale)
   {
+    const double radius = 0.5 * scale * std::sqrt(
+        static_cast<double>(canvas_->width() * canvas_->width() +
+                            canvas_->height() * canvas_->height()));
+
     const QColor color = ui_.color->color();
     glColor4d(color.redF(), color.greenF(), color.blueF(), 1.0);
 
     if (draw_style_ == LINES)
     {
       glLineWidth(3);
-      glBegin(GL_LINE_STRIP);
+      route_buffer_.Draw(GL_LINE_STRIP, x, y, radius);
     }
     else
     {
       glPointSize(2);
-      glBegin(GL_POINTS);
-    }
-
-    for (size_t i = 0; i < route.points.size(); i++)
-    {
-      glVertex2d(route.points[i].position().x(),
-                 route.points[i].position().y());
+      route_buffer_.Draw(GL_POINTS, x, y, radius);
     }
-    glEnd();
   }
 
   void RoutePlugin::DrawRoutePoint(const sru::RoutePoint& point)
@@ -0,0 +1,109 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz_plugins/shared_message_cache.h>
+
+#include <map>
+#include <utility>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace mapviz_plugins
+{
+  namespace
+  {
+    // The typed message is only weakly referenced, so the cache never keeps
+    // a decoded message alive after the displays have dropped it.
+    struct CacheEntry
+    {
+      boost::weak_ptr<const topic_tools::ShapeShifter> source;
+      boost::weak_ptr<const void> typed;
+    };
+
+    typedef std::pair<const topic_tools::ShapeShifter*, std::type_index> CacheKey;
+
+    boost::mutex cache_mutex;
+    std::map<CacheKey, CacheEntry> cache;
+
+    // Drops the entries whose message is gone; the cache mutex must be held
+    void PurgeExpired()
+    {
+      for (std::map<CacheKey, CacheEntry>::iterator it = cache.begin(); it != cache.end();)
+      {
+        if (it->second.source.expired() || it->second.typed.expired())
+        {
+          cache.erase(it++);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+    }
+  }
+
+  boost::shared_ptr<const void> SharedMessageCache::Find(
+      const topic_tools::ShapeShifter::ConstPtr& msg,
+      const std::type_index& type)
+  {
+    boost::mutex::scoped_lock lock(cache_mutex);
+
+    PurgeExpired();
+
+    std::map<CacheKey, CacheEntry>::iterator it = cache.find(CacheKey(msg.get(), type));
+    if (it == cache.end())
+    {
+      return boost::shared_ptr<const void>();
+    }
+
+    // The address may have been reused by a newer message
+    if (it->second.source.lock() != msg)
+    {
+      cache.erase(it);
+      return boost::shared_ptr<const void>();
+    }
+
+    return it->second.typed.lock();
+  }
+
+  void SharedMessageCache::Insert(
+      const topic_tools::ShapeShifter::ConstPtr& msg,
+      const std::type_index& type,
+      const boost::shared_ptr<const void>& typed)
+  {
+    boost::mutex::scoped_lock lock(cache_mutex);
+
+    PurgeExpired();
+
+    CacheEntry& entry = cache[CacheKey(msg.get(), type)];
+    entry.source = msg;
+    entry.typed = typed;
+  }
+}
@@ -0,0 +1,218 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <GL/glew.h>
+#include <mapviz_plugins/texture_cache.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// Boost libraries
+#include <boost/weak_ptr.hpp>
+
+// QT libraries
+#include <QDateTime>
+#include <QFileInfo>
+#include <QGLContext>
+#include <QImage>
+
+// ROS libraries
+#include <ros/package.h>
+
+namespace mapviz_plugins
+{
+  namespace
+  {
+    struct CacheEntry
+    {
+      QDateTime modified;
+      boost::weak_ptr<const TextureCache::Texture> texture;
+    };
+
+    std::map<std::string, CacheEntry> cache;
+
+    struct TextureDeleter
+    {
+      void operator()(const TextureCache::Texture* texture) const
+      {
+        if (QGLContext::currentContext() != NULL)
+        {
+          glDeleteTextures(1, &texture->id);
+        }
+        delete texture;
+      }
+    };
+
+    const GLfloat QUAD_VERTICES[] = {
+      -0.5f, 0.5f,
+      0.5f, 0.5f,
+      0.5f, -0.5f,
+      -0.5f, -0.5f };
+
+    const GLfloat QUAD_TEX_COORDS[] = {
+      0.0f, 1.0f,
+      1.0f, 1.0f,
+      1.0f, 0.0f,
+      0.0f, 0.0f };
+  }
+
+  std::string TextureCache::ResolvePath(const std::string& filename)
+  {
+    const std::string prefix = "$(find ";
+    size_t spos = filename.find(prefix);
+    bool has_close = spos != std::string::npos ? filename.find(')', spos) != std::string::npos : false;
+    if (spos != std::string::npos && spos + prefix.length() < filename.size() && has_close)
+    {
+      std::string package = filename.substr(spos + prefix.length());
+      package = package.substr(0, package.find(")"));
+
+      return ros::package::getPath(package) + filename.substr(filename.find(')')+1);
+    }
+
+    return filename;
+  }
+
+  TextureCache::TexturePtr TextureCache::Get(const std::string& path)
+  {
+    // Drop the textures that no display holds on to anymore
+    for (std::map<std::string, CacheEntry>::iterator it = cache.begin(); it != cache.end();)
+    {
+      if (it->second.texture.expired())
+      {
+        cache.erase(it++);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    // Reload the image if the file has changed since it was loaded
+    QDateTime modified = QFileInfo(QString::fromStdString(path)).lastModified();
+
+    std::map<std::string, CacheEntry>::iterator it = cache.find(path);
+    if (it != cache.end() && it->second.modified == modified)
+    {
+      return it->second.texture.lock();
+    }
+
+    QImage image;
+    if (!image.load(QString::fromStdString(path)))
+    {
+      return TexturePtr();
+    }
+
+    Texture* texture = new Texture();
+    texture->size = image.size();
+
+    // Stretch to a square power of two so that every mipmap level is well
+    // defined; the quad's texture coordinates cover the whole texture, so
+    // the stretch is undone when it is drawn.
+    float max_dim = std::max(image.width(), image.height());
+    int dimension = static_cast<int>(std::pow(2, std::ceil(std::log(max_dim) / std::log(2.0f))));
+    if (image.width() != dimension || image.height() != dimension)
+    {
+      image = image.scaled(dimension, dimension, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    image = QGLWidget::convertToGLFormat(image);
+
+    glGenTextures(1, &texture->id);
+    glBindTexture(GL_TEXTURE_2D, texture->id);
+
+    bool generate_mipmap = GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object;
+    if (!generate_mipmap)
+    {
+      // Pre-3.0 fallback; the levels are generated on upload
+      glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+    }
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimension, dimension, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+
+    if (generate_mipmap)
+    {
+      glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    TexturePtr shared(texture, TextureDeleter());
+
+    CacheEntry& entry = cache[path];
+    entry.modified = modified;
+    entry.texture = shared;
+
+    return shared;
+  }
+
+  void TextureCache::DrawQuad(const Texture& texture)
+  {
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, QUAD_VERTICES);
+    glTexCoordPointer(2, GL_FLOAT, 0, QUAD_TEX_COORDS);
+
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+  }
+
+  void TextureCache::DrawQuad(const Texture& texture, const GLdouble* corners)
+  {
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, corners);
+    glTexCoordPointer(2, GL_FLOAT, 0, QUAD_TEX_COORDS);
+
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+  }
+}
@@ -32,6 +32,7 @@
 // C++ standard libraries
 #include <cstdio>
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 // QT libraries
@@ -40,6 +41,7 @@
 
 // ROS libraries
 #include <ros/master.h>
+#include <tf/transform_listener.h>
 
 #include <mapviz/select_frame_dialog.h>
 
@@ -49,10 +51,25 @@ PLUGINLIB_EXPORT_CLASS(mapviz_plugins::TfFramePlugin, mapviz::MapvizPlugin)
 
 namespace mapviz_plugins
 {
+  // Upper bound on the sampling rate; TF can publish at several hundred Hz.
+  static const double MIN_SAMPLE_INTERVAL = 0.02;
+  static const double CHAIN_REFRESH_INTERVAL = 2.0;
+
+  static std::string StripSlash(const std::string& frame)
+  {
+    if (!frame.empty() && frame[0] == '/')
+    {
+      return frame.substr(1);
+    }
+    return frame;
+  }
+
   TfFramePlugin::TfFramePlugin() : config_widget_(new QWidget())
   {
     ui_.setupUi(config_widget_);
 
+    sample_timer_.setSingleShot(true);
+
     ui_.color->setColor(Qt::green);
 
     // Set background white
@@ -71,6 +88,8 @@ namespace mapviz_plugins
                      SLOT(FrameEdited()));
     QObject::connect(ui_.positiontolerance, SIGNAL(valueChanged(double)), this,
                      SLOT(PositionToleranceChanged(double)));
+    QObject::connect(ui_.pointinterval, SIGNAL(valueChanged(double)), this,
+                     SLOT(PointIntervalChanged(double)));
     QObject::connect(ui_.buffersize, SIGNAL(valueChanged(int)), this,
                      SLOT(BufferSizeChanged(int)));
     QObject::connect(ui_.drawstyle, SIGNAL(activated(QString)), this,
@@ -89,6 +108,11 @@ namespace mapviz_plugins
                      SIGNAL(TargetFrameChanged(const std::string&)),
                      this,
                      SLOT(ClearPoints()));
+    QObject::connect(this,
+                     SIGNAL(TargetFrameChanged(const std::string&)),
+                     this,
+                     SLOT(TargetFrameEdited()));
+    QObject::connect(&sample_timer_, SIGNAL(timeout()), this, SLOT(Sample()));
   }
 
   TfFramePlugin::~TfFramePlugin()
@@ -115,13 +139,123 @@ namespace mapviz_plugins
     ClearPoints();
 
     initialized_ = true;
+
+    last_sample_stamp_ = ros::Time();
+    UpdateChain();
+    Sample();
+  }
+
+  void TfFramePlugin::TargetFrameEdited()
+  {
+    last_sample_stamp_ = ros::Time();
+    UpdateChain();
+    Sample();
+  }
+
+  void TfFramePlugin::UpdateChain()
+  {
+    chain_.clear();
+    chain_updated_ = ros::WallTime::now();
+
+    if (!tf_ || source_frame_.empty() || target_frame_.empty())
+    {
+      return;
+    }
+
+    // The frames whose parent transform connects source and target are the
+    // ones that appear in exactly one of the two ancestor lists.
+    std::set<std::string> ancestors[2];
+    std::string frames[2] = { StripSlash(source_frame_),
+                              StripSlash(target_frame_) };
+    for (int i = 0; i < 2; i++)
+    {
+      std::string frame = frames[i];
+      std::string parent;
+      while (ancestors[i].insert(frame).second &&
+             tf_->getParent(frame, ros::Time(), parent))
+      {
+        frame = StripSlash(parent);
+      }
+    }
+
+    if (ancestors[0].size() == 1 && ancestors[1].count(frames[0]) == 0)
+    {
+      // The source frame isn't known yet, so there's no chain to filter on.
+      return;
+    }
+
+    std::set_symmetric_difference(
+        ancestors[0].begin(), ancestors[0].end(),
+        ancestors[1].begin(), ancestors[1].end(),
+        std::inserter(chain_, chain_.begin()));
+  }
+
+  bool TfFramePlugin::ChainContains(const std::string& frame) const
+  {
+    return chain_.empty() || chain_.count(StripSlash(frame)) > 0;
   }
 
-  void TfFramePlugin::TimerCallback(const ros::TimerEvent& event)
+  void TfFramePlugin::TfCallback(const tf2_msgs::TFMessageConstPtr& msg)
   {
+    if (!initialized_)
+    {
+      return;
+    }
+
+    ros::WallTime now = ros::WallTime::now();
+    if ((now - chain_updated_).toSec() > CHAIN_REFRESH_INTERVAL)
+    {
+      UpdateChain();
+    }
+
+    bool relevant = false;
+    for (const auto& transform: msg->transforms)
+    {
+      if (ChainContains(transform.child_frame_id))
+      {
+        relevant = true;
+        break;
+      }
+    }
+
+    if (!relevant)
+    {
+      return;
+    }
+
+    double elapsed = (now - last_sample_).toSec();
+    if (elapsed >= MIN_SAMPLE_INTERVAL)
+    {
+      Sample();
+      elapsed = 0.0;
+    }
+
+    // The listener stores this message on its own thread, possibly after
+    // the sample above was taken, and the last update of a burst may have
+    // been throttled.  One more sample after the last relevant message
+    // picks up both.
+    if (!sample_timer_.isActive())
+    {
+      sample_timer_.start(
+          static_cast<int>((MIN_SAMPLE_INTERVAL - elapsed) * 1000.0) + 1);
+    }
+  }
+
+  void TfFramePlugin::Sample()
+  {
+    sample_timer_.stop();
+    last_sample_ = ros::WallTime::now();
+
     swri_transform_util::Transform transform;
     if (GetTransform(ros::Time(), transform))
     {
+      if (!last_sample_stamp_.isZero() &&
+          transform.GetStamp() == last_sample_stamp_)
+      {
+        return;
+      }
+      last_sample_stamp_ = transform.GetStamp();
+
       StampedPoint stamped_point;
       stamped_point.point = transform.GetOrigin();
       stamped_point.orientation = transform.GetOrientation();
@@ -159,8 +293,12 @@ namespace mapviz_plugins
   {
     canvas_ = canvas;
 
-    timer_ = node_.createTimer(ros::Duration(0.1),
-                               &TfFramePlugin::TimerCallback, this);
+    SubscribeLazily(tf_sub_, [this]() {
+      return node_.subscribe("/tf", 100, &TfFramePlugin::TfCallback, this);
+    });
+    SubscribeLazily(tf_static_sub_, [this]() {
+      return node_.subscribe("/tf_static", 100, &TfFramePlugin::TfCallback, this);
+    });
 
     SetColor(ui_.color->color());
 
@@ -222,6 +360,13 @@ namespace mapviz_plugins
       PositionToleranceChanged(position_tolerance);
     }
 
+    if (node["point_interval"])
+    {
+      double point_interval = node["point_interval"].as<double>();
+      ui_.pointinterval->setValue(point_interval);
+      PointIntervalChanged(point_interval);
+    }
+
     if (node["buffer_size"])
     {
       double buffer_size;
@@ -268,6 +413,8 @@ namespace mapviz_plugins
     emitter << YAML::Key << "position_tolerance" <<
                YAML::Value << positionTolerance();
 
+    emitter << YAML::Key << "point_interval" << YAML::Value << pointInterval();
+
     emitter << YAML::Key << "buffer_size" << YAML::Value << bufferSize();
 
     emitter << YAML::Key << "static_arrow_sizes" << YAML::Value << ui_.static_arrow_sizes->isChecked();
@@ -0,0 +1,130 @@
+// *****************************************************************************
+//
+// Copyright (c) 2026, Southwest Research Institute® (SwRI®)
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Southwest Research Institute® (SwRI®) nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// *****************************************************************************
+
+#include <mapviz_plugins/vertex_picker.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// QT libraries
+#include <QLineF>
+
+namespace mapviz_plugins
+{
+  VertexPicker::VertexPicker() :
+    valid_(false),
+    cell_size_(0.0)
+  {
+  }
+
+  void VertexPicker::SetVertices(const std::vector<tf::Vector3>& vertices)
+  {
+    vertices_.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+      vertices_[i] = QPointF(vertices[i].x(), vertices[i].y());
+    }
+    valid_ = false;
+  }
+
+  void VertexPicker::Clear()
+  {
+    vertices_.clear();
+    screen_.clear();
+    cells_.clear();
+    valid_ = false;
+  }
+
+  void VertexPicker::Build(const QTransform& view, double radius)
+  {
+    view_ = view;
+    cell_size_ = radius;
+
+    screen_.resize(vertices_.size());
+    cells_.resize(vertices_.size());
+    for (size_t i = 0; i < vertices_.size(); i++)
+    {
+      screen_[i] = view.map(vertices_[i]);
+      int64_t cell_x = static_cast<int64_t>(std::floor(screen_[i].x() / cell_size_));
+      int64_t cell_y = static_cast<int64_t>(std::floor(screen_[i].y() / cell_size_));
+      cells_[i] = std::make_pair(CellKey(cell_x, cell_y), static_cast<int>(i));
+    }
+    std::sort(cells_.begin(), cells_.end());
+
+    valid_ = true;
+  }
+
+  int VertexPicker::Pick(const QTransform& view, const QPointF& point, double radius)
+  {
+    if (vertices_.empty() || radius <= 0.0)
+    {
+      return -1;
+    }
+
+    if (!valid_ || view != view_ || radius != cell_size_)
+    {
+      Build(view, radius);
+    }
+
+    int closest = -1;
+    double closest_distance = std::numeric_limits<double>::max();
+
+    int64_t cell_x = static_cast<int64_t>(std::floor(point.x() / cell_size_));
+    int64_t cell_y = static_cast<int64_t>(std::floor(point.y() / cell_size_));
+    for (int64_t x = cell_x - 1; x <= cell_x + 1; x++)
+    {
+      for (int64_t y = cell_y - 1; y <= cell_y + 1; y++)
+      {
+        int64_t key = CellKey(x, y);
+        auto it = std::lower_bound(
+            cells_.begin(), cells_.end(), std::make_pair(key, 0));
+        for (; it != cells_.end() && it->first == key; ++it)
+        {
+          double distance = QLineF(screen_[it->second], point).length();
+          // Ties go to the lowest index, like a linear scan would.
+          if (distance < closest_distance ||
+              (distance == closest_distance && it->second < closest))
+          {
+            closest_distance = distance;
+            closest = it->second;
+          }
+        }
+      }
+    }
+
+    if (closest_distance >= radius)
+    {
+      return -1;
+    }
+
+    return closest;
+  }
+}